@@ -0,0 +1,153 @@
+// ArenaAllocator.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This header file declares a class template called ArenaAllocator, an
+// allocator that standard containers (e.g., std::list or std::vector) can
+// be told to use, which hands out memory from an arena: a
+// std::pmr::monotonic_buffer_resource that carves each allocation out of
+// a few large blocks, makes giving memory back a no-op, and frees all of
+// its blocks at once when it's destroyed.  A graph that makes one small
+// allocation for every edge it's given gets them from contiguous blocks
+// instead of scattering them across the heap, and destroying it no longer
+// takes one call to free for each of them.
+//
+// Each ArenaAllocator shares ownership of its arena, so the arena lives
+// as long as any container whose memory came from it.  An ArenaAllocator
+// that has no arena takes its memory from the heap as usual.
+//
+// Arenas aren't safe for more than one thread to allocate from at once,
+// so a copy of a container doesn't carry over its arena; it takes its
+// memory from the heap instead.  Assigning or swapping containers carries
+// their ArenaAllocators along with their contents.
+
+#ifndef ARENAALLOCATOR_HPP
+#define ARENAALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+
+
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+    typedef std::false_type is_always_equal;
+
+    // The default constructor initializes an ArenaAllocator with no arena,
+    // which takes its memory from the heap.
+    ArenaAllocator() noexcept = default;
+
+    // This constructor initializes an ArenaAllocator that takes its memory
+    // from the given arena.
+    explicit ArenaAllocator(std::shared_ptr<std::pmr::memory_resource> arena) noexcept;
+
+    // This constructor initializes an ArenaAllocator for Ts that uses the
+    // same arena as the given one (as containers need in order to allocate
+    // their nodes, rather than the values in them).
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept;
+
+    // allocate() returns room for n Ts, and deallocate() gives it back
+    // (which, for an arena, does nothing until the arena is destroyed).
+    T* allocate(std::size_t n);
+    void deallocate(T* p, std::size_t n) noexcept;
+
+    // select_on_container_copy_construction() is called by a container
+    // that's being copied, and returns an ArenaAllocator with no arena for
+    // the copy to use.
+    ArenaAllocator select_on_container_copy_construction() const noexcept;
+
+    // arena() returns the arena, or nullptr if there is none.
+    const std::shared_ptr<std::pmr::memory_resource>& arena() const noexcept;
+
+private:
+    std::shared_ptr<std::pmr::memory_resource> resource;
+};
+
+
+
+// Two ArenaAllocators are equal if memory that came from either can be
+// given back to the other, which is when they share an arena (or neither
+// has one).
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept
+{
+    return a.arena() == b.arena();
+}
+
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept
+{
+    return !(a == b);
+}
+
+
+
+template <typename T>
+ArenaAllocator<T>::ArenaAllocator(std::shared_ptr<std::pmr::memory_resource> arena) noexcept
+    : resource{std::move(arena)}
+{
+}
+
+
+template <typename T>
+template <typename U>
+ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+    : resource{other.arena()}
+{
+}
+
+
+template <typename T>
+T* ArenaAllocator<T>::allocate(std::size_t n)
+{
+    if(resource == nullptr)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(resource->allocate(n * sizeof(T), alignof(T)));
+}
+
+
+template <typename T>
+void ArenaAllocator<T>::deallocate(T* p, std::size_t n) noexcept
+{
+    if(resource == nullptr)
+    {
+        ::operator delete(p);
+    }
+    else
+    {
+        resource->deallocate(p, n * sizeof(T), alignof(T));
+    }
+}
+
+
+template <typename T>
+ArenaAllocator<T> ArenaAllocator<T>::select_on_container_copy_construction() const noexcept
+{
+    return ArenaAllocator{};
+}
+
+
+template <typename T>
+const std::shared_ptr<std::pmr::memory_resource>& ArenaAllocator<T>::arena() const noexcept
+{
+    return resource;
+}
+
+
+
+#endif // ARENAALLOCATOR_HPP
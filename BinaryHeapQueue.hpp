@@ -0,0 +1,98 @@
+// BinaryHeapQueue.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A BinaryHeapQueue is the priority queue a shortest path search uses by
+// default: a binary min-heap of (key, vertex index) pairs.  It doesn't
+// support decreasing the key of a vertex already in it, so push() simply
+// adds another entry for the vertex, and the search is expected to skip
+// entries that have gone stale by the time they're popped (e.g., because
+// their vertex has already been settled).  When two entries have the same
+// key, the one with the smaller vertex index is popped first, just as with
+// a std::priority_queue of pairs ordered by std::greater.
+//
+// Every priority queue a search can use (see also IndexedHeapQueue and
+// RadixHeapQueue) has the same member functions as this one.
+
+#ifndef BINARYHEAPQUEUE_HPP
+#define BINARYHEAPQUEUE_HPP
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+
+
+class BinaryHeapQueue
+{
+public:
+    // reserve() prepares the queue to hold the vertices of a graph with
+    // the given number of vertices.
+    void reserve(int vertexCount);
+
+    // clear() removes every entry from the queue.
+    void clear() noexcept;
+
+    // empty() returns true if the queue has no entries, false otherwise.
+    bool empty() const noexcept;
+
+    // top() returns the (key, vertex index) pair with the smallest key.
+    // The queue must not be empty.
+    const std::pair<double, int>& top() const noexcept;
+
+    // push() adds an entry for the vertex at the given index with the
+    // given key.
+    void push(int index, double key);
+
+    // pop() removes the entry that top() returns.  The queue must not be
+    // empty.
+    void pop();
+
+private:
+    std::vector<std::pair<double, int>> heap;
+};
+
+
+
+inline void BinaryHeapQueue::reserve(int)
+{
+}
+
+
+inline void BinaryHeapQueue::clear() noexcept
+{
+    heap.clear();
+}
+
+
+inline bool BinaryHeapQueue::empty() const noexcept
+{
+    return heap.empty();
+}
+
+
+inline const std::pair<double, int>& BinaryHeapQueue::top() const noexcept
+{
+    return heap.front();
+}
+
+
+inline void BinaryHeapQueue::push(int index, double key)
+{
+    heap.push_back(std::make_pair(key, index));
+    std::push_heap(heap.begin(), heap.end(), std::greater<std::pair<double, int>>{});
+}
+
+
+inline void BinaryHeapQueue::pop()
+{
+    std::pop_heap(heap.begin(), heap.end(), std::greater<std::pair<double, int>>{});
+    heap.pop_back();
+}
+
+
+
+#endif // BINARYHEAPQUEUE_HPP
+
@@ -0,0 +1,135 @@
+// CompactArray.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A CompactArray is a read-only array of values that either owns them (in
+// a std::vector it was given) or refers to values that live somewhere else,
+// such as a file mapped into memory by a MappedFile.  Either way, whatever
+// holds the values is kept alive by a std::shared_ptr for as long as any
+// CompactArray refers to it, so copying a CompactArray is cheap and never
+// copies the values themselves.
+//
+// The arrays that make up a CompactDigraph are CompactArrays, which is how
+// one can be built either from a Digraph or straight from a road map file
+// without copying the file's contents.
+
+#ifndef COMPACTARRAY_HPP
+#define COMPACTARRAY_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+
+template <typename T>
+class CompactArray
+{
+public:
+    // The default constructor initializes an empty CompactArray.
+    CompactArray();
+
+    // This constructor initializes a CompactArray that owns the values in
+    // the given std::vector.
+    explicit CompactArray(std::vector<T> values);
+
+    // This constructor initializes a CompactArray that refers to the given
+    // number of values starting at the given address, which stay valid for
+    // as long as the given owner does.
+    CompactArray(std::shared_ptr<const void> owner, const T* values, std::size_t size);
+
+    // size() returns the number of values in the array, and empty() returns
+    // true if there are none, false otherwise.
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    // operator[] returns the value at the given position.
+    const T& operator[](std::size_t position) const noexcept;
+
+    // data(), begin() and end() return pointers to the first value and one
+    // past the last.
+    const T* data() const noexcept;
+    const T* begin() const noexcept;
+    const T* end() const noexcept;
+
+private:
+    std::shared_ptr<const void> owner;
+    const T* values;
+    std::size_t count;
+};
+
+
+
+template <typename T>
+CompactArray<T>::CompactArray()
+    : values{nullptr}, count{0}
+{
+}
+
+
+template <typename T>
+CompactArray<T>::CompactArray(std::vector<T> values)
+{
+    std::shared_ptr<const std::vector<T>> owned =
+        std::make_shared<const std::vector<T>>(std::move(values));
+
+    this->values = owned->data();
+    count = owned->size();
+    owner = std::move(owned);
+}
+
+
+template <typename T>
+CompactArray<T>::CompactArray(std::shared_ptr<const void> owner, const T* values, std::size_t size)
+    : owner{std::move(owner)}, values{values}, count{size}
+{
+}
+
+
+template <typename T>
+std::size_t CompactArray<T>::size() const noexcept
+{
+    return count;
+}
+
+
+template <typename T>
+bool CompactArray<T>::empty() const noexcept
+{
+    return count == 0;
+}
+
+
+template <typename T>
+const T& CompactArray<T>::operator[](std::size_t position) const noexcept
+{
+    return values[position];
+}
+
+
+template <typename T>
+const T* CompactArray<T>::data() const noexcept
+{
+    return values;
+}
+
+
+template <typename T>
+const T* CompactArray<T>::begin() const noexcept
+{
+    return values;
+}
+
+
+template <typename T>
+const T* CompactArray<T>::end() const noexcept
+{
+    return values + count;
+}
+
+
+
+#endif // COMPACTARRAY_HPP
+
@@ -0,0 +1,1885 @@
+// CompactDigraph.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This header file declares a class template called CompactDigraph, which
+// is a read-only snapshot of a Digraph.  Where each vertex of a Digraph
+// owns a std::list of its outgoing edges, a CompactDigraph lays the same
+// graph out in compressed sparse row (CSR) form:
+//
+// * every vertex is given a dense index in the range [0, vertexCount())
+// * the outgoing edges of the vertex with index i occupy the contiguous
+//   range [offsets[i], offsets[i + 1]) of the edge arrays
+// * the edge arrays hold the target vertex index and the EdgeInfo of
+//   each edge, side by side in memory
+//
+// A CompactDigraph never changes once it's been built, which makes it the
+// right structure to answer many queries against a graph that was built
+// once (e.g., a RoadMap read by a RoadMapReader).  Walking the outgoing
+// edges of a vertex is a linear scan through memory instead of a chase
+// through list nodes.
+//
+// Alongside the outgoing edges, a CompactDigraph keeps a reverse index that
+// lists the incoming edges of each vertex in the same CSR form, so searches
+// can run backward from a vertex just as cheaply as forward.
+//
+// The arrays are CompactArrays, so a CompactDigraph can also be assembled
+// from arrays that were built elsewhere (e.g., ones that refer to a road
+// map file mapped into memory), without copying them; see
+// CompactDigraphArrays.
+
+#ifndef COMPACTDIGRAPH_HPP
+#define COMPACTDIGRAPH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+#include "CompactArray.hpp"
+#include "Digraph.hpp"
+#include "DijkstraWorkspace.hpp"
+#include "DistanceMatrix.hpp"
+#include "EdgeWeightColumn.hpp"
+#include "ShortestPathTree.hpp"
+#include "StronglyConnectedComponents.hpp"
+#include "VertexIndex.hpp"
+#include "WorkStealingPool.hpp"
+
+
+
+// A DigraphPath is the result of a point-to-point shortest path query: the
+// vertex numbers along the path, in order from the start vertex to the end
+// vertex, and the total weight of its edges.  Along with them come the
+// edges themselves, so that a path can be followed without looking any of
+// them up: edges[i] is the position (see CompactDigraph::edgeInfoAt()) of
+// the edge from vertices[i] to vertices[i + 1], and costs[i] is the total
+// weight of the path from the start vertex as far as vertices[i].  When
+// the end vertex can't be reached from the start vertex, vertices, edges
+// and costs are empty and cost is infinite, and found() says so.
+
+struct DigraphPath
+{
+    std::vector<int> vertices;
+    double cost;
+    std::vector<int> edges;
+    std::vector<double> costs;
+
+    bool found() const noexcept
+    {
+        return !vertices.empty();
+    }
+};
+
+
+
+// A ReachedVertex is one of the vertices found by a bounded search (see
+// CompactDigraph::findVerticesWithin()): its vertex number, and the cost
+// of a shortest path to it from the start vertex.
+
+struct ReachedVertex
+{
+    int vertex;
+    double cost;
+};
+
+
+
+// A CompactDigraphArrays holds the arrays that make up a CompactDigraph
+// with n vertices and m edges, as described above:
+//
+// * ids (n values) holds the vertex number of each index, and vinfos (n
+//   values) holds its VertexInfo
+// * offsets (n + 1 values, from 0 up to m) holds the range of positions
+//   of each index's outgoing edges, and targets and einfos (m values each)
+//   hold the target index and EdgeInfo of the edge at each position
+// * reverseOffsets (n + 1 values) holds the range of reverse positions of
+//   each index's incoming edges, and reverseSources and reverseEdges (m
+//   values each) hold the source index and the (outgoing) edge position
+//   of the incoming edge at each reverse position
+
+template <typename VertexInfo, typename EdgeInfo>
+struct CompactDigraphArrays
+{
+    CompactArray<int> ids;
+    CompactArray<VertexInfo> vinfos;
+    CompactArray<int> offsets;
+    CompactArray<int> targets;
+    CompactArray<EdgeInfo> einfos;
+    CompactArray<int> reverseOffsets;
+    CompactArray<int> reverseSources;
+    CompactArray<int> reverseEdges;
+};
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+class CompactDigraph
+{
+public:
+    // The default constructor initializes an empty CompactDigraph, which
+    // contains no vertices and no edges.
+    CompactDigraph();
+
+    // This constructor takes a snapshot of the given Digraph.  Vertices
+    // are indexed in the order the Digraph's vertices() reports them and
+    // each vertex's edges keep the order in which they were added.
+    explicit CompactDigraph(const Digraph<VertexInfo, EdgeInfo>& d);
+
+    // This constructor assembles a CompactDigraph from the given arrays,
+    // sharing them rather than copying them.  If the reverse arrays are
+    // all empty, the reverse index is built from the outgoing edges.  The
+    // sizes of the arrays are checked, as is that no vertex number appears
+    // twice, and a DigraphException is thrown if they're inconsistent; the
+    // values in the CSR arrays are trusted.
+    explicit CompactDigraph(CompactDigraphArrays<VertexInfo, EdgeInfo> arrays);
+
+    // arrays() returns the arrays that make up this CompactDigraph, which
+    // share their values with it.
+    CompactDigraphArrays<VertexInfo, EdgeInfo> arrays() const;
+
+    // withEdgeInfos() returns a CompactDigraph with the same vertices and
+    // edges as this one, sharing everything with it except the EdgeInfo
+    // objects, which come from the given array instead (in edge position
+    // order).  It takes constant time.  If the array has the wrong number
+    // of values, a DigraphException is thrown instead.
+    CompactDigraph withEdgeInfos(CompactArray<EdgeInfo> edgeInfos) const;
+
+    // renumbered() returns a CompactDigraph with the same vertices and
+    // edges as this one, laid out in the given order: the vertex at index
+    // r of the result is the one at index order[r] of this one (e.g., as
+    // chosen by one of the functions in VertexOrder.hpp).  Vertex numbers
+    // and VertexInfos go with their vertices, so nothing changes for code
+    // that works in terms of vertex numbers, but indices and edge
+    // positions do; each vertex's edges keep their order.  The order in
+    // which vertices are settled also follows the indices, so where there
+    // are several shortest paths, a different one may be chosen.  It takes
+    // O(V + E) time.  If the order isn't a permutation of the indices, a
+    // DigraphException is thrown instead.
+    CompactDigraph renumbered(const std::vector<int>& order) const;
+
+    // weightColumn() returns an EdgeWeightColumn holding the weight of
+    // every edge under the given edge weight function.  Every member
+    // function below that takes an edge weight function can be given the
+    // EdgeWeightColumn in its place, as long as it came from this
+    // CompactDigraph (or one with the same edges), and then finds the same
+    // paths and costs without calling the function again.
+    template <typename EdgeWeightFunc>
+    EdgeWeightColumn weightColumn(EdgeWeightFunc edgeWeightFunc) const;
+
+    // vertices() returns a std::vector containing the vertex numbers of
+    // every vertex in this CompactDigraph, in index order.
+    std::vector<int> vertices() const;
+
+    // edges() returns a std::vector of std::pairs, in which each pair
+    // contains the "from" and "to" vertex numbers of an edge outgoing
+    // from the given vertex.  If the given vertex does not exist, a
+    // DigraphException is thrown instead.
+    std::vector<std::pair<int, int>> edges(int vertex) const;
+
+    // vertexInfo() returns the VertexInfo object belonging to the vertex
+    // with the given vertex number.  If that vertex does not exist, a
+    // DigraphException is thrown instead.
+    const VertexInfo& vertexInfo(int vertex) const;
+
+    // edgeInfo() returns the EdgeInfo object belonging to the edge
+    // with the given "from" and "to" vertex numbers.  If either of those
+    // vertices does not exist *or* if the edge does not exist, a
+    // DigraphException is thrown instead.
+    const EdgeInfo& edgeInfo(int fromVertex, int toVertex) const;
+
+    // vertexCount() returns the number of vertices in the graph.
+    int vertexCount() const noexcept;
+
+    // edgeCount() returns the total number of edges in the graph.
+    int edgeCount() const noexcept;
+
+    // This overload of edgeCount() returns the number of edges in the
+    // graph that are outgoing from the given vertex number.  If the
+    // given vertex does not exist, a DigraphException is thrown instead.
+    int edgeCount(int vertex) const;
+
+    // isStronglyConnected() returns true if every vertex is reachable
+    // from every other, false otherwise.  It runs in O(V + E) time by
+    // checking that one vertex reaches, and is reached by, all others.
+    bool isStronglyConnected() const;
+
+    // stronglyConnectedComponents() returns the strongly connected
+    // component of each vertex index, numbered as the Digraph member
+    // function of the same name numbers them.  It takes O(V + E) time.
+    std::vector<int> stronglyConnectedComponents() const;
+
+    // findShortestPaths() behaves exactly like the Digraph member function
+    // of the same name, returning a std::map from each vertex number to
+    // its predecessor on a shortest path from the start vertex (or to
+    // itself, for the start vertex and any unreachable vertex).  If the
+    // start vertex does not exist, a DigraphException is thrown instead.
+    std::map<int, int> findShortestPaths(
+        int startVertex,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc) const;
+
+    // This overload of findShortestPaths() takes the edge weight function
+    // as a template parameter, so that it can be inlined into the search.
+    template <typename EdgeWeightFunc>
+    std::map<int, int> findShortestPaths(
+        int startVertex, EdgeWeightFunc edgeWeightFunc) const;
+
+    // findShortestPath() finds one shortest path from the start vertex to
+    // the end vertex, given the same kind of edge weight function as
+    // findShortestPaths().  It runs Dijkstra's algorithm from the start
+    // vertex, but stops as soon as the end vertex is settled instead of
+    // settling the whole graph, and it settles vertices in the same order,
+    // so it chooses the same path findShortestPaths() would.  If either
+    // vertex does not exist, a DigraphException is thrown instead.
+    template <typename EdgeWeightFunc>
+    DigraphPath findShortestPath(
+        int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc) const;
+
+    // This overload of findShortestPath() does the same thing, but uses
+    // the given DijkstraWorkspace as its scratch space instead of
+    // allocating its own.  The workspace can have any kind of priority
+    // queue (see DijkstraWorkspace.hpp); this, like the other overloads
+    // that take a workspace, chooses the same path with a BinaryHeapQueue
+    // as with an IndexedHeapQueue, but may choose a different one among
+    // several shortest paths when it's given a RadixHeapQueue.
+    template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats>
+    DigraphPath findShortestPath(
+        int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+        BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace) const;
+
+    // findShortestPathsTo() finds a shortest path from the start vertex to
+    // each of the given end vertices, returning them in the same order.
+    // It's one search that stops once every end vertex is settled, and it
+    // chooses the same paths findShortestPath() would for each of them.
+    // If any of the vertices does not exist, a DigraphException is thrown
+    // instead.
+    template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats>
+    std::vector<DigraphPath> findShortestPathsTo(
+        int startVertex, const std::vector<int>& endVertices,
+        EdgeWeightFunc edgeWeightFunc, BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace) const;
+
+    // findVerticesWithin() returns every vertex that can be reached from
+    // the start vertex by a path costing no more than the given budget,
+    // along with that cost, in order of cost (as they're settled).  The
+    // search stops at the first vertex past the budget, so, in a reused
+    // workspace, a query costs time proportional to the part of the graph
+    // within the budget rather than to the whole graph.  If the start
+    // vertex does not exist, a DigraphException is thrown instead.
+    template <typename EdgeWeightFunc>
+    std::vector<ReachedVertex> findVerticesWithin(
+        int startVertex, double budget, EdgeWeightFunc edgeWeightFunc) const;
+
+    // This overload of findVerticesWithin() uses the given
+    // DijkstraWorkspace as its scratch space.
+    template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats>
+    std::vector<ReachedVertex> findVerticesWithin(
+        int startVertex, double budget, EdgeWeightFunc edgeWeightFunc,
+        BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace) const;
+
+    // distanceMatrix() returns the cost of a shortest path from each of the
+    // given source vertices (the rows) to each of the given target vertices
+    // (the columns), infinite where there's none.  It's one search from
+    // each source that stops once every target is settled, and the searches
+    // are spread over the workers of the given WorkStealingPool.  A graph
+    // with a ContractionHierarchy can answer the same query much faster
+    // with that hierarchy's distanceMatrix().  If any of the vertices does
+    // not exist, a DigraphException is thrown instead.
+    template <typename EdgeWeightFunc>
+    DistanceMatrix distanceMatrix(
+        const std::vector<int>& sourceVertices,
+        const std::vector<int>& targetVertices,
+        EdgeWeightFunc edgeWeightFunc, WorkStealingPool& pool) const;
+
+    // This overload of distanceMatrix() uses the given DijkstraWorkspaces,
+    // one for each worker of the pool, as the scratch space of the
+    // searches.
+    template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats>
+    DistanceMatrix distanceMatrix(
+        const std::vector<int>& sourceVertices,
+        const std::vector<int>& targetVertices,
+        EdgeWeightFunc edgeWeightFunc, WorkStealingPool& pool,
+        std::vector<BasicDijkstraWorkspace<PriorityQueue, Stats>>& workspaces) const;
+
+    // findShortestPathTree() settles the whole graph from the start vertex
+    // and returns the resulting ShortestPathTree, which pathTo() can then
+    // answer queries from.  If the start vertex does not exist, a
+    // DigraphException is thrown instead.
+    template <typename EdgeWeightFunc>
+    ShortestPathTree findShortestPathTree(
+        int startVertex, EdgeWeightFunc edgeWeightFunc) const;
+
+    // This overload of findShortestPathTree() uses the given
+    // DijkstraWorkspace as its scratch space.
+    template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats>
+    ShortestPathTree findShortestPathTree(
+        int startVertex, EdgeWeightFunc edgeWeightFunc,
+        BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace) const;
+
+    // This overload of findShortestPathTree() settles the whole graph by
+    // delta-stepping instead, spreading the work over the workers of the
+    // given WorkStealingPool.  Vertices are kept in buckets of the given
+    // width according to their tentative distances, and the outgoing edges
+    // of every vertex in the lowest nonempty bucket are relaxed at once, in
+    // parallel, until no vertex is left in it (a vertex whose distance
+    // drops while its bucket is being emptied is relaxed again).  The
+    // distances come out exactly as Dijkstra's algorithm would find them,
+    // and each vertex is then given the predecessor that the other
+    // overloads would choose with a BinaryHeapQueue, so the tree is the
+    // same one, whatever the bucket width or the number of workers.
+    //
+    // A narrower bucket wastes less work on vertices whose distances drop
+    // again later, while a wider one gives the workers more vertices to
+    // share at a time; a width around the weight of a typical edge is a
+    // reasonable start.  The buckets are reused in a cycle, one for every
+    // width's worth of the heaviest edge, and a width so narrow that this
+    // would take more than 65,536 of them is widened until it doesn't.
+    // If the start vertex does not exist, or the bucket width isn't
+    // positive, a DigraphException is thrown instead.
+    template <typename EdgeWeightFunc>
+    ShortestPathTree findShortestPathTree(
+        int startVertex, EdgeWeightFunc edgeWeightFunc, double bucketWidth,
+        WorkStealingPool& pool) const;
+
+    // pathTo() returns the path to the given end vertex recorded in a tree
+    // built by findShortestPathTree(), which is the path findShortestPath()
+    // would have found.  If the vertex does not exist, a DigraphException
+    // is thrown instead.
+    DigraphPath pathTo(const ShortestPathTree& tree, int endVertex) const;
+
+    // findShortestPathBidirectional() answers the same query by growing
+    // two searches in turn, one forward from the start vertex and one
+    // backward from the end vertex along incoming edges, and stops once
+    // no vertex left in either search could lead to a shorter path than
+    // the best one found through a vertex both have reached.  When there
+    // are several shortest paths, it may choose a different one than
+    // findShortestPath() does.
+    template <typename EdgeWeightFunc>
+    DigraphPath findShortestPathBidirectional(
+        int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc) const;
+
+    // This overload of findShortestPathBidirectional() uses the given
+    // DijkstraWorkspaces as the scratch space of the forward and backward
+    // searches; they must be two different workspaces.
+    template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats>
+    DigraphPath findShortestPathBidirectional(
+        int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+        BasicDijkstraWorkspace<PriorityQueue, Stats>& forward,
+        BasicDijkstraWorkspace<PriorityQueue, Stats>& backward) const;
+
+    // findShortestPathAStar() answers the same query with the A* algorithm,
+    // which steers the search toward the end vertex.  Along with the edge
+    // weight function, it takes a heuristic function that's given a vertex
+    // number and returns an estimate of the cost of the cheapest path from
+    // that vertex to the end vertex.  As long as the estimate never exceeds
+    // the true cost, the path found is a shortest path; the closer the
+    // estimate is to the true cost, the fewer vertices are searched.  A
+    // heuristic that always returns 0 makes this Dijkstra's algorithm.
+    template <typename EdgeWeightFunc, typename HeuristicFunc>
+    DigraphPath findShortestPathAStar(
+        int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+        HeuristicFunc heuristicFunc) const;
+
+    // This overload of findShortestPathAStar() uses the given
+    // DijkstraWorkspace as its scratch space.  Its queue can only be a
+    // RadixHeapQueue if the heuristic is consistent (i.e., the estimate
+    // never drops along an edge by more than the edge's weight), since
+    // otherwise the keys popped from the queue needn't keep increasing.
+    template <typename EdgeWeightFunc, typename HeuristicFunc, typename PriorityQueue, typename Stats>
+    DigraphPath findShortestPathAStar(
+        int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+        HeuristicFunc heuristicFunc, BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace) const;
+
+
+    // The remaining member functions expose the CSR layout directly, for
+    // algorithms that work in terms of dense vertex indices and edge
+    // positions rather than vertex numbers.
+
+    // indexOf() returns the dense index of the given vertex number.  If
+    // the vertex does not exist, a DigraphException is thrown instead.
+    int indexOf(int vertex) const;
+
+    // vertexAt() returns the vertex number stored at the given index.
+    int vertexAt(int index) const noexcept;
+
+    // edgeBegin() and edgeEnd() return the half-open range of edge
+    // positions holding the outgoing edges of the vertex at an index.
+    int edgeBegin(int index) const noexcept;
+    int edgeEnd(int index) const noexcept;
+
+    // edgeTarget() returns the index of the vertex to which the edge at
+    // the given position points.
+    int edgeTarget(int edge) const noexcept;
+
+    // edgeInfoAt() returns the EdgeInfo of the edge at the given position.
+    const EdgeInfo& edgeInfoAt(int edge) const noexcept;
+
+    // edgePosition() returns the position of the edge from the vertex at
+    // one index to the vertex at another, or -1 if there is no such edge.
+    int edgePosition(int fromIndex, int toIndex) const noexcept;
+
+    // reverseEdgeBegin() and reverseEdgeEnd() return the half-open range
+    // of positions in the reverse index that hold the incoming edges of
+    // the vertex at an index.
+    int reverseEdgeBegin(int index) const noexcept;
+    int reverseEdgeEnd(int index) const noexcept;
+
+    // reverseEdgeSource() returns the index of the vertex from which the
+    // incoming edge at the given reverse position comes.
+    int reverseEdgeSource(int reverseEdge) const noexcept;
+
+    // reverseEdgeAt() returns the (outgoing) edge position of the incoming
+    // edge at the given reverse position.
+    int reverseEdgeAt(int reverseEdge) const noexcept;
+
+
+private:
+    // index -> vertex number, and vertex number -> index (which is shared,
+    // like the arrays, by the CompactDigraphs that withEdgeInfos() makes)
+    CompactArray<int> ids;
+    std::shared_ptr<const VertexIndex> indices;
+
+    // index -> VertexInfo
+    CompactArray<VertexInfo> vinfos;
+
+    // offsets has vertexCount() + 1 entries; the outgoing edges of the
+    // vertex at index i are at positions [offsets[i], offsets[i + 1])
+    CompactArray<int> offsets;
+    CompactArray<int> targets;
+    CompactArray<EdgeInfo> einfos;
+
+    // the reverse index: the incoming edges of the vertex at index i are
+    // at reverse positions [reverseOffsets[i], reverseOffsets[i + 1]),
+    // each naming its source vertex and its position in the arrays above
+    CompactArray<int> reverseOffsets;
+    CompactArray<int> reverseSources;
+    CompactArray<int> reverseEdges;
+
+    //fills in the reverse index from the outgoing edges
+    void buildReverseIndex();
+
+    //returns the weight of the edge at the given position, under either
+    //an edge weight function or an EdgeWeightColumn
+    template <typename EdgeWeightFunc>
+    double weightAt(const EdgeWeightFunc& edgeWeightFunc, int edge) const;
+    double weightAt(const EdgeWeightColumn& weights, int edge) const noexcept;
+
+    //visits every vertex index reachable from start, following either
+    //the outgoing edges or (via the given reversed CSR arrays) incoming ones
+    int countReachable(
+        int start, const CompactArray<int>& edgeOffsets,
+        const CompactArray<int>& edgeTargets) const;
+
+    //runs Dijkstra's algorithm from the vertex at index start in the given
+    //workspace, calling stop() with each vertex index as it's settled and
+    //stopping early if it returns true
+    template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats, typename StopFunc>
+    void runDijkstra(
+        int start, EdgeWeightFunc edgeWeightFunc,
+        BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace, StopFunc stop) const;
+
+    //delta-stepping hands workers this many vertices of a bucket at a time
+    static constexpr int deltaSteppingChunkSize = 256;
+
+    //delta-stepping never cycles through more buckets than this
+    static constexpr std::size_t deltaSteppingMaxBuckets = 1 << 16;
+
+    //fills in the predecessors of a tree whose distances are complete,
+    //choosing for each vertex the incoming edge that Dijkstra's algorithm
+    //would have reached it by first
+    template <typename EdgeWeightFunc>
+    void choosePredecessors(
+        ShortestPathTree& tree, const EdgeWeightFunc& edgeWeightFunc,
+        WorkStealingPool& pool) const;
+
+    //builds the DigraphPath from start to end by following predecessor
+    //indices back from end, as given by predecessor(index), with the cost
+    //of reaching each index given by distance(index); an end that was
+    //never reached has no path
+    template <typename PredecessorFunc, typename DistanceFunc>
+    DigraphPath tracePath(
+        int start, int end, PredecessorFunc predecessor, DistanceFunc distance) const;
+
+    //builds the DigraphPath from start to end found by the last search
+    //run in the given workspace
+    template <typename PriorityQueue, typename Stats>
+    DigraphPath tracePath(
+        int start, int end, BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace) const;
+};
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CompactDigraph<VertexInfo, EdgeInfo>::CompactDigraph()
+    : indices{std::make_shared<const VertexIndex>()},
+      offsets{std::vector<int>{0}}, reverseOffsets{std::vector<int>{0}}
+{
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CompactDigraph<VertexInfo, EdgeInfo>::CompactDigraph(const Digraph<VertexInfo, EdgeInfo>& d)
+{
+    // The Digraph's slots are used as the dense indices, so if removing
+    // vertices has left some empty, a compacted copy is taken instead.
+    if(static_cast<int>(d.v.read().size()) != d.vertexC)
+    {
+        Digraph<VertexInfo, EdgeInfo> compacted{d};
+        compacted.compact();
+        *this = CompactDigraph{compacted};
+        return;
+    }
+
+    indices = std::make_shared<const VertexIndex>(d.indices.read());
+
+    std::vector<VertexInfo> vertexInfos;
+    std::vector<int> edgeOffsets;
+    std::vector<int> edgeTargets;
+    std::vector<EdgeInfo> edgeInfos;
+    vertexInfos.reserve(d.vertexC);
+    edgeOffsets.reserve(d.vertexC + 1);
+    edgeTargets.reserve(d.edgeC);
+    edgeInfos.reserve(d.edgeC);
+
+    edgeOffsets.push_back(0);
+    for(int i = 0; i < d.vertexC; i++)
+    {
+        const DigraphVertex<VertexInfo, EdgeInfo>& vertex = d.vertexAt(i);
+        vertexInfos.push_back(vertex.vinfo);
+        for(const DigraphEdge<EdgeInfo>& edge: vertex.edges)
+        {
+            edgeTargets.push_back(indices->find(edge.toVertex));
+            edgeInfos.push_back(edge.einfo);
+        }
+        edgeOffsets.push_back(static_cast<int>(edgeTargets.size()));
+    }
+
+    ids = CompactArray<int>{d.v.read()};
+    vinfos = CompactArray<VertexInfo>{std::move(vertexInfos)};
+    offsets = CompactArray<int>{std::move(edgeOffsets)};
+    targets = CompactArray<int>{std::move(edgeTargets)};
+    einfos = CompactArray<EdgeInfo>{std::move(edgeInfos)};
+
+    buildReverseIndex();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CompactDigraph<VertexInfo, EdgeInfo>::CompactDigraph(CompactDigraphArrays<VertexInfo, EdgeInfo> arrays)
+    : ids{std::move(arrays.ids)}, vinfos{std::move(arrays.vinfos)},
+      offsets{std::move(arrays.offsets)}, targets{std::move(arrays.targets)},
+      einfos{std::move(arrays.einfos)},
+      reverseOffsets{std::move(arrays.reverseOffsets)},
+      reverseSources{std::move(arrays.reverseSources)},
+      reverseEdges{std::move(arrays.reverseEdges)}
+{
+    std::size_t n = ids.size();
+    std::size_t m = targets.size();
+
+    if(vinfos.size() != n || offsets.size() != n + 1
+       || offsets[0] != 0 || static_cast<std::size_t>(offsets[n]) != m
+       || einfos.size() != m)
+    {
+        throw DigraphException("Inconsistent CompactDigraph arrays");
+    }
+
+    if(reverseOffsets.empty() && reverseSources.empty() && reverseEdges.empty())
+    {
+        buildReverseIndex();
+    }
+    else if(reverseOffsets.size() != n + 1 || reverseSources.size() != m
+            || reverseEdges.size() != m)
+    {
+        throw DigraphException("Inconsistent CompactDigraph arrays");
+    }
+
+    VertexIndex index;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        if(index.find(ids[i]) != -1)
+        {
+            throw DigraphException("Vertex " + std::to_string(ids[i]) + " exist");
+        }
+        index.insert(ids[i], static_cast<int>(i));
+    }
+    indices = std::make_shared<const VertexIndex>(std::move(index));
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CompactDigraphArrays<VertexInfo, EdgeInfo> CompactDigraph<VertexInfo, EdgeInfo>::arrays() const
+{
+    return CompactDigraphArrays<VertexInfo, EdgeInfo>{
+        ids, vinfos, offsets, targets, einfos,
+        reverseOffsets, reverseSources, reverseEdges};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CompactDigraph<VertexInfo, EdgeInfo> CompactDigraph<VertexInfo, EdgeInfo>::withEdgeInfos(
+    CompactArray<EdgeInfo> edgeInfos) const
+{
+    if(edgeInfos.size() != einfos.size())
+    {
+        throw DigraphException("Inconsistent CompactDigraph arrays");
+    }
+
+    CompactDigraph result{*this};
+    result.einfos = std::move(edgeInfos);
+    return result;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CompactDigraph<VertexInfo, EdgeInfo> CompactDigraph<VertexInfo, EdgeInfo>::renumbered(
+    const std::vector<int>& order) const
+{
+    int n = vertexCount();
+    if(static_cast<int>(order.size()) != n)
+    {
+        throw DigraphException("Inconsistent vertex order");
+    }
+
+    std::vector<int> newIndices(n, -1);
+    for(int r = 0; r < n; r++)
+    {
+        if(order[r] < 0 || order[r] >= n || newIndices[order[r]] != -1)
+        {
+            throw DigraphException("Inconsistent vertex order");
+        }
+        newIndices[order[r]] = r;
+    }
+
+    std::vector<int> vertexNumbers;
+    std::vector<VertexInfo> vertexInfos;
+    std::vector<int> edgeOffsets;
+    std::vector<int> edgeTargets;
+    std::vector<EdgeInfo> edgeInfos;
+    vertexNumbers.reserve(n);
+    vertexInfos.reserve(n);
+    edgeOffsets.reserve(n + 1);
+    edgeTargets.reserve(edgeCount());
+    edgeInfos.reserve(edgeCount());
+
+    edgeOffsets.push_back(0);
+    for(int index: order)
+    {
+        vertexNumbers.push_back(ids[index]);
+        vertexInfos.push_back(vinfos[index]);
+        for(int edge = offsets[index]; edge < offsets[index + 1]; edge++)
+        {
+            edgeTargets.push_back(newIndices[targets[edge]]);
+            edgeInfos.push_back(einfos[edge]);
+        }
+        edgeOffsets.push_back(static_cast<int>(edgeTargets.size()));
+    }
+
+    // Leaving the reverse arrays empty has the constructor build them.
+    return CompactDigraph{CompactDigraphArrays<VertexInfo, EdgeInfo>{
+        CompactArray<int>{std::move(vertexNumbers)},
+        CompactArray<VertexInfo>{std::move(vertexInfos)},
+        CompactArray<int>{std::move(edgeOffsets)},
+        CompactArray<int>{std::move(edgeTargets)},
+        CompactArray<EdgeInfo>{std::move(edgeInfos)},
+        CompactArray<int>{}, CompactArray<int>{}, CompactArray<int>{}}};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+EdgeWeightColumn CompactDigraph<VertexInfo, EdgeInfo>::weightColumn(EdgeWeightFunc edgeWeightFunc) const
+{
+    std::vector<double> weights;
+    weights.reserve(edgeCount());
+    for(const EdgeInfo& einfo: einfos)
+    {
+        weights.push_back(edgeWeightFunc(einfo));
+    }
+    return EdgeWeightColumn{std::move(weights)};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<int> CompactDigraph<VertexInfo, EdgeInfo>::vertices() const
+{
+    return std::vector<int>(ids.begin(), ids.end());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<std::pair<int, int>> CompactDigraph<VertexInfo, EdgeInfo>::edges(int vertex) const
+{
+    int index = indexOf(vertex);
+    std::vector<std::pair<int, int>> result;
+    result.reserve(offsets[index + 1] - offsets[index]);
+    for(int edge = offsets[index]; edge < offsets[index + 1]; edge++)
+    {
+        result.push_back(std::make_pair(vertex, ids[targets[edge]]));
+    }
+    return result;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const VertexInfo& CompactDigraph<VertexInfo, EdgeInfo>::vertexInfo(int vertex) const
+{
+    return vinfos[indexOf(vertex)];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const EdgeInfo& CompactDigraph<VertexInfo, EdgeInfo>::edgeInfo(int fromVertex, int toVertex) const
+{
+    int edge = edgePosition(indexOf(fromVertex), indexOf(toVertex));
+    if(edge == -1)
+    {
+        throw DigraphException("No such edge exist");
+    }
+    return einfos[edge];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::vertexCount() const noexcept
+{
+    return static_cast<int>(ids.size());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::edgeCount() const noexcept
+{
+    return static_cast<int>(targets.size());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::edgeCount(int vertex) const
+{
+    int index = indexOf(vertex);
+    return offsets[index + 1] - offsets[index];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+bool CompactDigraph<VertexInfo, EdgeInfo>::isStronglyConnected() const
+{
+    int n = vertexCount();
+    if(n == 0)
+    {
+        return true;
+    }
+
+    if(countReachable(0, offsets, targets) != n)
+    {
+        return false;
+    }
+
+    return countReachable(0, reverseOffsets, reverseSources) == n;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<int> CompactDigraph<VertexInfo, EdgeInfo>::stronglyConnectedComponents() const
+{
+    return findStronglyConnectedComponents(vertexCount(), offsets, targets);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, int> CompactDigraph<VertexInfo, EdgeInfo>::findShortestPaths(
+    int startVertex,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc) const
+{
+    return findShortestPaths<const std::function<double(const EdgeInfo&)>&>(
+        startVertex, edgeWeightFunc);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+std::map<int, int> CompactDigraph<VertexInfo, EdgeInfo>::findShortestPaths(
+    int startVertex, EdgeWeightFunc edgeWeightFunc) const
+{
+    int n = vertexCount();
+    int startIndex = indexOf(startVertex);
+
+    DijkstraWorkspace workspace;
+    runDijkstra(
+        startIndex, edgeWeightFunc, workspace,
+        [](int)
+        {
+            return false;
+        });
+
+    std::map<int, int> result;
+    for(int i = 0; i < n; i++)
+    {
+        int predecessor = workspace.predecessor(i);
+        result.emplace_hint(result.end(), ids[i], ids[predecessor == -1 ? i : predecessor]);
+    }
+    return result;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+DigraphPath CompactDigraph<VertexInfo, EdgeInfo>::findShortestPath(
+    int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc) const
+{
+    DijkstraWorkspace workspace;
+    return findShortestPath(startVertex, endVertex, edgeWeightFunc, workspace);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats>
+DigraphPath CompactDigraph<VertexInfo, EdgeInfo>::findShortestPath(
+    int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace) const
+{
+    int startIndex = indexOf(startVertex);
+    int endIndex = indexOf(endVertex);
+
+    runDijkstra(
+        startIndex, edgeWeightFunc, workspace,
+        [endIndex](int index)
+        {
+            return index == endIndex;
+        });
+
+    return tracePath(startIndex, endIndex, workspace);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats>
+std::vector<DigraphPath> CompactDigraph<VertexInfo, EdgeInfo>::findShortestPathsTo(
+    int startVertex, const std::vector<int>& endVertices,
+    EdgeWeightFunc edgeWeightFunc, BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace) const
+{
+    int startIndex = indexOf(startVertex);
+    std::vector<int> endIndices;
+    endIndices.reserve(endVertices.size());
+    for(int endVertex: endVertices)
+    {
+        endIndices.push_back(indexOf(endVertex));
+    }
+
+    if(endIndices.empty())
+    {
+        return std::vector<DigraphPath>{};
+    }
+
+    // The search can stop once the last end vertex not yet settled is; an
+    // end vertex may appear more than once, but is only counted once.  The
+    // end vertices are looked up in a sorted copy, rather than marked in a
+    // vector as large as the graph, so that a search that stops early only
+    // costs time proportional to the part of the graph it reached.
+    std::vector<int> wanted = endIndices;
+    std::sort(wanted.begin(), wanted.end());
+    wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+    int remaining = static_cast<int>(wanted.size());
+
+    runDijkstra(
+        startIndex, edgeWeightFunc, workspace,
+        [&wanted, &remaining](int index)
+        {
+            return std::binary_search(wanted.begin(), wanted.end(), index)
+                && --remaining == 0;
+        });
+
+    std::vector<DigraphPath> paths;
+    paths.reserve(endIndices.size());
+    for(int index: endIndices)
+    {
+        paths.push_back(tracePath(startIndex, index, workspace));
+    }
+    return paths;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+std::vector<ReachedVertex> CompactDigraph<VertexInfo, EdgeInfo>::findVerticesWithin(
+    int startVertex, double budget, EdgeWeightFunc edgeWeightFunc) const
+{
+    DijkstraWorkspace workspace;
+    return findVerticesWithin(startVertex, budget, edgeWeightFunc, workspace);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats>
+std::vector<ReachedVertex> CompactDigraph<VertexInfo, EdgeInfo>::findVerticesWithin(
+    int startVertex, double budget, EdgeWeightFunc edgeWeightFunc,
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace) const
+{
+    int startIndex = indexOf(startVertex);
+    std::vector<ReachedVertex> reached;
+
+    // Vertices are settled in order of cost, so the first one past the
+    // budget means every one after it is, too.
+    runDijkstra(
+        startIndex, edgeWeightFunc, workspace,
+        [this, &workspace, &reached, budget](int index)
+        {
+            double cost = workspace.distance(index);
+            if(!(cost <= budget))
+            {
+                return true;
+            }
+            reached.push_back(ReachedVertex{ids[index], cost});
+            return false;
+        });
+
+    return reached;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+DistanceMatrix CompactDigraph<VertexInfo, EdgeInfo>::distanceMatrix(
+    const std::vector<int>& sourceVertices,
+    const std::vector<int>& targetVertices,
+    EdgeWeightFunc edgeWeightFunc, WorkStealingPool& pool) const
+{
+    std::vector<DijkstraWorkspace> workspaces(pool.workerCount());
+    return distanceMatrix(sourceVertices, targetVertices, edgeWeightFunc, pool, workspaces);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats>
+DistanceMatrix CompactDigraph<VertexInfo, EdgeInfo>::distanceMatrix(
+    const std::vector<int>& sourceVertices,
+    const std::vector<int>& targetVertices,
+    EdgeWeightFunc edgeWeightFunc, WorkStealingPool& pool,
+    std::vector<BasicDijkstraWorkspace<PriorityQueue, Stats>>& workspaces) const
+{
+    std::vector<int> sources;
+    std::vector<int> targets;
+    sources.reserve(sourceVertices.size());
+    targets.reserve(targetVertices.size());
+    for(int vertex: sourceVertices)
+    {
+        sources.push_back(indexOf(vertex));
+    }
+    for(int vertex: targetVertices)
+    {
+        targets.push_back(indexOf(vertex));
+    }
+
+    int rows = static_cast<int>(sources.size());
+    int columns = static_cast<int>(targets.size());
+    DistanceMatrix matrix{rows, columns};
+    if(columns == 0)
+    {
+        return matrix;
+    }
+
+    // Every search looks for the same targets, so they're marked once in a
+    // vector as large as the graph, which all of the searches share.
+    std::vector<bool> wanted(vertexCount(), false);
+    int targetCount = 0;
+    for(int index: targets)
+    {
+        if(!wanted[index])
+        {
+            wanted[index] = true;
+            targetCount++;
+        }
+    }
+
+    pool.run(
+        rows,
+        [&](int worker, int r)
+        {
+            BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace = workspaces[worker];
+            int remaining = targetCount;
+            runDijkstra(
+                sources[r], edgeWeightFunc, workspace,
+                [&wanted, &remaining](int index)
+                {
+                    return wanted[index] && --remaining == 0;
+                });
+
+            double* row = matrix.row(r);
+            for(int column = 0; column < columns; column++)
+            {
+                row[column] = workspace.distance(targets[column]);
+            }
+        });
+
+    return matrix;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+ShortestPathTree CompactDigraph<VertexInfo, EdgeInfo>::findShortestPathTree(
+    int startVertex, EdgeWeightFunc edgeWeightFunc) const
+{
+    DijkstraWorkspace workspace;
+    return findShortestPathTree(startVertex, edgeWeightFunc, workspace);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats>
+ShortestPathTree CompactDigraph<VertexInfo, EdgeInfo>::findShortestPathTree(
+    int startVertex, EdgeWeightFunc edgeWeightFunc,
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace) const
+{
+    int n = vertexCount();
+    int startIndex = indexOf(startVertex);
+
+    runDijkstra(
+        startIndex, edgeWeightFunc, workspace,
+        [](int)
+        {
+            return false;
+        });
+
+    ShortestPathTree tree{startIndex, std::vector<double>(n), std::vector<int>(n)};
+    for(int i = 0; i < n; i++)
+    {
+        tree.distance[i] = workspace.distance(i);
+        tree.predecessor[i] = workspace.predecessor(i);
+    }
+    return tree;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+ShortestPathTree CompactDigraph<VertexInfo, EdgeInfo>::findShortestPathTree(
+    int startVertex, EdgeWeightFunc edgeWeightFunc, double bucketWidth,
+    WorkStealingPool& pool) const
+{
+    int n = vertexCount();
+    int startIndex = indexOf(startVertex);
+    if(!(bucketWidth > 0))
+    {
+        throw DigraphException("Bucket width must be positive");
+    }
+
+    // Workers lower distances by compare-and-swap, so two of them relaxing
+    // edges into the same vertex at once can't undo each other's work.
+    // The pool finishes each batch before run() returns, so between
+    // batches, every distance is up to date.
+    std::vector<std::atomic<double>> distance(n);
+    for(int i = 0; i < n; i++)
+    {
+        distance[i].store(std::numeric_limits<double>::infinity(), std::memory_order_relaxed);
+    }
+    distance[startIndex].store(0, std::memory_order_relaxed);
+
+    // While bucket b is being emptied, every distance that's lowered lands
+    // within the heaviest edge of b's, so it's in one of the next
+    // heaviest / width + 1 buckets, and that many buckets after b can be
+    // kept in a cycle.  (Edges whose weight is infinite never lower a
+    // distance, so they don't count.)  A width so narrow that the cycle
+    // would be too long is widened, which also keeps every finite
+    // distance's bucket number, at most (n - 1) * heaviest / width, well
+    // within a std::size_t.
+    double heaviest = 0;
+    for(int edge = 0; edge < offsets[n]; edge++)
+    {
+        double weight = weightAt(edgeWeightFunc, edge);
+        if(weight > heaviest && weight < std::numeric_limits<double>::infinity())
+        {
+            heaviest = weight;
+        }
+    }
+    bucketWidth = std::max(bucketWidth, heaviest / (deltaSteppingMaxBuckets - 2));
+    std::size_t bucketCount = std::min(
+        static_cast<std::size_t>(heaviest / bucketWidth) + 2, deltaSteppingMaxBuckets);
+
+    auto bucketOf =
+        [&distance, bucketWidth](int index)
+        {
+            return static_cast<std::size_t>(distance[index].load(std::memory_order_relaxed) / bucketWidth);
+        };
+
+    // Each worker lists the vertices whose distances it lowered, and after
+    // each batch they're moved to the buckets their distances now put them
+    // in, or to the next batch if that's the bucket being emptied.  A vertex
+    // can be listed more than once, and can be left behind in a bucket it's
+    // since moved out of, so queued[i] is the last batch the vertex at
+    // index i was taken for, and stale entries are passed over.  Bucket b
+    // is kept at buckets[b % bucketCount], and waiting counts the entries
+    // in all of them, stale or not.
+    std::vector<std::vector<int>> lowered(pool.workerCount());
+    std::vector<std::vector<int>> buckets(bucketCount);
+    buckets[0].push_back(startIndex);
+    std::size_t waiting = 1;
+    std::vector<unsigned> queued(n, 0);
+    unsigned batch = 0;
+    std::vector<int> frontier;
+
+    auto relax =
+        [&](int worker, int begin, int end)
+        {
+            for(int i = begin; i < end; i++)
+            {
+                int index = frontier[i];
+                double d = distance[index].load(std::memory_order_relaxed);
+                for(int edge = offsets[index]; edge < offsets[index + 1]; edge++)
+                {
+                    std::atomic<double>& target = distance[targets[edge]];
+                    double dw = d + weightAt(edgeWeightFunc, edge);
+                    double current = target.load(std::memory_order_relaxed);
+                    while(dw < current)
+                    {
+                        if(target.compare_exchange_weak(current, dw, std::memory_order_relaxed))
+                        {
+                            lowered[worker].push_back(targets[edge]);
+                            break;
+                        }
+                    }
+                }
+            }
+        };
+
+    for(std::size_t b = 0; waiting > 0; b++)
+    {
+        std::vector<int>& entries = buckets[b % bucketCount];
+        if(entries.empty())
+        {
+            continue;
+        }
+
+        batch++;
+        frontier.clear();
+        for(int index: entries)
+        {
+            if(queued[index] != batch && bucketOf(index) == b)
+            {
+                queued[index] = batch;
+                frontier.push_back(index);
+            }
+        }
+        waiting -= entries.size();
+        entries.clear();
+
+        while(!frontier.empty())
+        {
+            int count = static_cast<int>(frontier.size());
+            int chunks = (count + deltaSteppingChunkSize - 1) / deltaSteppingChunkSize;
+            if(chunks <= 1)
+            {
+                relax(0, 0, count);
+            }
+            else
+            {
+                pool.run(
+                    chunks,
+                    [&](int worker, int chunk)
+                    {
+                        int begin = chunk * deltaSteppingChunkSize;
+                        relax(worker, begin, std::min(count, begin + deltaSteppingChunkSize));
+                    });
+            }
+
+            // Relaxing an edge never lowers a distance below the one it
+            // starts from, so nothing moves to a bucket before b.
+            batch++;
+            frontier.clear();
+            for(std::vector<int>& indices: lowered)
+            {
+                for(int index: indices)
+                {
+                    std::size_t bucket = bucketOf(index);
+                    if(bucket != b)
+                    {
+                        buckets[bucket % bucketCount].push_back(index);
+                        waiting++;
+                    }
+                    else if(queued[index] != batch)
+                    {
+                        queued[index] = batch;
+                        frontier.push_back(index);
+                    }
+                }
+                indices.clear();
+            }
+        }
+    }
+
+    ShortestPathTree tree{startIndex, std::vector<double>(n), std::vector<int>(n, -1)};
+    for(int i = 0; i < n; i++)
+    {
+        tree.distance[i] = distance[i].load(std::memory_order_relaxed);
+    }
+    choosePredecessors(tree, edgeWeightFunc, pool);
+    return tree;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphPath CompactDigraph<VertexInfo, EdgeInfo>::pathTo(const ShortestPathTree& tree, int endVertex) const
+{
+    int endIndex = indexOf(endVertex);
+    return tracePath(
+        tree.startIndex, endIndex,
+        [&tree](int index)
+        {
+            return tree.predecessor[index];
+        },
+        [&tree](int index)
+        {
+            return tree.distance[index];
+        });
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+DigraphPath CompactDigraph<VertexInfo, EdgeInfo>::findShortestPathBidirectional(
+    int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc) const
+{
+    DijkstraWorkspace forward;
+    DijkstraWorkspace backward;
+    return findShortestPathBidirectional(startVertex, endVertex, edgeWeightFunc, forward, backward);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats>
+DigraphPath CompactDigraph<VertexInfo, EdgeInfo>::findShortestPathBidirectional(
+    int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& forward,
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& backward) const
+{
+    int n = vertexCount();
+    int startIndex = indexOf(startVertex);
+    int endIndex = indexOf(endVertex);
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    // The forward search (F) finds distances from the start vertex and the
+    // backward search (B) finds distances to the end vertex.
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& F = forward;
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& B = backward;
+    F.reset(n);
+    B.reset(n);
+    F.stats.startSearch();
+    F.reach(startIndex, 0, -1);
+    B.reach(endIndex, 0, -1);
+
+    PriorityQueue& pqF = F.queue;
+    PriorityQueue& pqB = B.queue;
+    pqF.push(startIndex, 0);
+    pqB.push(endIndex, 0);
+    F.stats.countPush();
+    B.stats.countPush();
+
+    // best is the cost of the shortest path found so far, which passes
+    // through the vertex at index meet.
+    double best = startIndex == endIndex ? 0 : infinity;
+    int meet = startIndex == endIndex ? startIndex : -1;
+
+    while (!pqF.empty() && !pqB.empty() && pqF.top().first + pqB.top().first < best)
+    {
+        if(pqF.top().first <= pqB.top().first)
+        {
+            int index = pqF.top().second;
+            pqF.pop();
+            F.stats.countPop();
+
+            if(F.settled(index) == false)
+            {
+                F.settle(index);
+                F.stats.countSettle();
+                for(int edge = offsets[index]; edge < offsets[index + 1]; edge++)
+                {
+                    int indexW = targets[edge];
+                    double d = F.distance(index) + weightAt(edgeWeightFunc, edge);
+                    F.stats.countRelax();
+                    if(F.distance(indexW) > d)
+                    {
+                        F.reach(indexW, d, index);
+                        pqF.push(indexW, d);
+                        F.stats.countPush();
+                    }
+                    if(F.distance(indexW) + B.distance(indexW) < best)
+                    {
+                        best = F.distance(indexW) + B.distance(indexW);
+                        meet = indexW;
+                    }
+                }
+            }
+            else
+            {
+                F.stats.countStalePop();
+            }
+        }
+        else
+        {
+            int index = pqB.top().second;
+            pqB.pop();
+            B.stats.countPop();
+
+            if(B.settled(index) == false)
+            {
+                B.settle(index);
+                B.stats.countSettle();
+                for(int edge = reverseOffsets[index]; edge < reverseOffsets[index + 1]; edge++)
+                {
+                    int indexW = reverseSources[edge];
+                    double d = B.distance(index) + weightAt(edgeWeightFunc, reverseEdges[edge]);
+                    B.stats.countRelax();
+                    if(B.distance(indexW) > d)
+                    {
+                        B.reach(indexW, d, index);
+                        pqB.push(indexW, d);
+                        B.stats.countPush();
+                    }
+                    if(F.distance(indexW) + B.distance(indexW) < best)
+                    {
+                        best = F.distance(indexW) + B.distance(indexW);
+                        meet = indexW;
+                    }
+                }
+            }
+            else
+            {
+                B.stats.countStalePop();
+            }
+        }
+    }
+
+    F.stats.stopSearch();
+    if(meet == -1)
+    {
+        return tracePath(startIndex, endIndex, F);
+    }
+
+    // The forward predecessors lead from meet back to the start vertex,
+    // and the backward ones lead from meet on to the end vertex.
+    DigraphPath path = tracePath(startIndex, meet, F);
+    B.stats.startPaths();
+    path.cost = best;
+    int previous = meet;
+    for(int index = B.predecessor(meet); index != -1; index = B.predecessor(index))
+    {
+        int edge = edgePosition(previous, index);
+        path.vertices.push_back(ids[index]);
+        path.edges.push_back(edge);
+        path.costs.push_back(path.costs.back() + weightAt(edgeWeightFunc, edge));
+        previous = index;
+    }
+    B.stats.stopPaths();
+    return path;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc, typename HeuristicFunc>
+DigraphPath CompactDigraph<VertexInfo, EdgeInfo>::findShortestPathAStar(
+    int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+    HeuristicFunc heuristicFunc) const
+{
+    DijkstraWorkspace workspace;
+    return findShortestPathAStar(startVertex, endVertex, edgeWeightFunc, heuristicFunc, workspace);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc, typename HeuristicFunc, typename PriorityQueue, typename Stats>
+DigraphPath CompactDigraph<VertexInfo, EdgeInfo>::findShortestPathAStar(
+    int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+    HeuristicFunc heuristicFunc, BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace) const
+{
+    int startIndex = indexOf(startVertex);
+    int endIndex = indexOf(endVertex);
+
+    // The workspace's estimates cache the heuristic of each vertex, which
+    // is computed the first time the vertex is reached.
+    workspace.reset(vertexCount());
+    workspace.stats.startSearch();
+    workspace.reach(startIndex, 0, -1);
+    workspace.setEstimate(startIndex, heuristicFunc(startVertex));
+
+    // The queue is ordered by distance plus heuristic.  An entry whose key
+    // no longer matches its vertex's is stale and is skipped; a vertex is
+    // expanded again whenever its distance improves, so a heuristic that
+    // never overestimates is enough to find a shortest path, even if it
+    // isn't consistent.
+    PriorityQueue& pq = workspace.queue;
+    pq.push(startIndex, workspace.estimate(startIndex));
+    workspace.stats.countPush();
+    while (!pq.empty())
+    {
+        double key = pq.top().first;
+        int index = pq.top().second;
+        pq.pop();
+        workspace.stats.countPop();
+
+        if(key == workspace.distance(index) + workspace.estimate(index))
+        {
+            workspace.stats.countSettle();
+            if(index == endIndex)
+            {
+                break;
+            }
+            for(int edge = offsets[index]; edge < offsets[index + 1]; edge++)
+            {
+                int indexW = targets[edge];
+                double d = workspace.distance(index) + weightAt(edgeWeightFunc, edge);
+                workspace.stats.countRelax();
+                if(workspace.distance(indexW) > d)
+                {
+                    if(std::isnan(workspace.estimate(indexW)))
+                    {
+                        workspace.setEstimate(indexW, heuristicFunc(ids[indexW]));
+                    }
+                    workspace.reach(indexW, d, index);
+                    pq.push(indexW, d + workspace.estimate(indexW));
+                    workspace.stats.countPush();
+                }
+            }
+        }
+        else
+        {
+            workspace.stats.countStalePop();
+        }
+    }
+    workspace.stats.stopSearch();
+
+    return tracePath(startIndex, endIndex, workspace);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::indexOf(int vertex) const
+{
+    int index = indices->find(vertex);
+    if(index == -1)
+    {
+        throw DigraphException("Vertex " + std::to_string(vertex) + "not exist");
+    }
+    return index;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::vertexAt(int index) const noexcept
+{
+    return ids[index];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::edgeBegin(int index) const noexcept
+{
+    return offsets[index];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::edgeEnd(int index) const noexcept
+{
+    return offsets[index + 1];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::edgeTarget(int edge) const noexcept
+{
+    return targets[edge];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const EdgeInfo& CompactDigraph<VertexInfo, EdgeInfo>::edgeInfoAt(int edge) const noexcept
+{
+    return einfos[edge];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::edgePosition(int fromIndex, int toIndex) const noexcept
+{
+    for(int edge = offsets[fromIndex]; edge < offsets[fromIndex + 1]; edge++)
+    {
+        if(targets[edge] == toIndex)
+        {
+            return edge;
+        }
+    }
+    return -1;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::reverseEdgeBegin(int index) const noexcept
+{
+    return reverseOffsets[index];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::reverseEdgeEnd(int index) const noexcept
+{
+    return reverseOffsets[index + 1];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::reverseEdgeSource(int reverseEdge) const noexcept
+{
+    return reverseSources[reverseEdge];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::reverseEdgeAt(int reverseEdge) const noexcept
+{
+    return reverseEdges[reverseEdge];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void CompactDigraph<VertexInfo, EdgeInfo>::buildReverseIndex()
+{
+    int n = vertexCount();
+
+    // Count the incoming edges of each vertex, turn the counts into
+    // offsets, then drop each edge into the next free slot of its target.
+    std::vector<int> incomingOffsets(n + 1, 0);
+    for(int target: targets)
+    {
+        incomingOffsets[target + 1]++;
+    }
+    for(int i = 0; i < n; i++)
+    {
+        incomingOffsets[i + 1] += incomingOffsets[i];
+    }
+
+    std::vector<int> incomingSources(targets.size());
+    std::vector<int> incomingEdges(targets.size());
+    std::vector<int> next(incomingOffsets.begin(), incomingOffsets.end() - 1);
+    for(int from = 0; from < n; from++)
+    {
+        for(int edge = offsets[from]; edge < offsets[from + 1]; edge++)
+        {
+            int slot = next[targets[edge]]++;
+            incomingSources[slot] = from;
+            incomingEdges[slot] = edge;
+        }
+    }
+
+    reverseOffsets = CompactArray<int>{std::move(incomingOffsets)};
+    reverseSources = CompactArray<int>{std::move(incomingSources)};
+    reverseEdges = CompactArray<int>{std::move(incomingEdges)};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::countReachable(
+    int start, const CompactArray<int>& edgeOffsets,
+    const CompactArray<int>& edgeTargets) const
+{
+    std::vector<bool> visited(vertexCount(), false);
+    std::vector<int> stack{start};
+    visited[start] = true;
+    int count = 1;
+    while(!stack.empty())
+    {
+        int index = stack.back();
+        stack.pop_back();
+        for(int edge = edgeOffsets[index]; edge < edgeOffsets[index + 1]; edge++)
+        {
+            int w = edgeTargets[edge];
+            if(!visited[w])
+            {
+                visited[w] = true;
+                count++;
+                stack.push_back(w);
+            }
+        }
+    }
+    return count;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+double CompactDigraph<VertexInfo, EdgeInfo>::weightAt(const EdgeWeightFunc& edgeWeightFunc, int edge) const
+{
+    return edgeWeightFunc(einfos[edge]);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+double CompactDigraph<VertexInfo, EdgeInfo>::weightAt(const EdgeWeightColumn& weights, int edge) const noexcept
+{
+    return weights[edge];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc, typename PriorityQueue, typename Stats, typename StopFunc>
+void CompactDigraph<VertexInfo, EdgeInfo>::runDijkstra(
+    int start, EdgeWeightFunc edgeWeightFunc,
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace, StopFunc stop) const
+{
+    workspace.reset(vertexCount());
+    workspace.stats.startSearch();
+    PriorityQueue& pq = workspace.queue;
+
+    workspace.reach(start, 0, -1);
+    pq.push(start, 0);
+    workspace.stats.countPush();
+    while (!pq.empty())
+    {
+        int index = pq.top().second;
+        pq.pop();
+        workspace.stats.countPop();
+
+        if(workspace.settled(index) == false)
+        {
+            workspace.settle(index);
+            workspace.stats.countSettle();
+            if(stop(index))
+            {
+                break;
+            }
+            double distance = workspace.distance(index);
+            for(int edge = offsets[index]; edge < offsets[index + 1]; edge++)
+            {
+                int indexW = targets[edge];
+                double d = distance + weightAt(edgeWeightFunc, edge);
+                workspace.stats.countRelax();
+                if(workspace.distance(indexW) > d)
+                {
+                    workspace.reach(indexW, d, index);
+                    pq.push(indexW, d);
+                    workspace.stats.countPush();
+                }
+            }
+        }
+        else
+        {
+            workspace.stats.countStalePop();
+        }
+    }
+    workspace.stats.stopSearch();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+void CompactDigraph<VertexInfo, EdgeInfo>::choosePredecessors(
+    ShortestPathTree& tree, const EdgeWeightFunc& edgeWeightFunc, WorkStealingPool& pool) const
+{
+    int n = vertexCount();
+    const std::vector<double>& distance = tree.distance;
+    std::vector<int>& predecessor = tree.predecessor;
+
+    // Dijkstra's algorithm leaves each vertex with the predecessor that
+    // first reached it at its final distance: the first to be settled of
+    // the vertices u with an edge for which distance[u] plus its weight is
+    // exactly that distance.  Vertices are settled in order of distance, so
+    // that's the one with the lowest distance, unless several share it.
+    std::vector<char> tied(n, 0);
+    auto choose =
+        [&](int begin, int end)
+        {
+            for(int index = begin; index < end; index++)
+            {
+                if(index == tree.startIndex || distance[index] == std::numeric_limits<double>::infinity())
+                {
+                    continue;
+                }
+                int best = -1;
+                for(int r = reverseOffsets[index]; r < reverseOffsets[index + 1]; r++)
+                {
+                    int u = reverseSources[r];
+                    if(distance[u] + weightAt(edgeWeightFunc, reverseEdges[r]) != distance[index])
+                    {
+                        continue;
+                    }
+                    if(best == -1 || distance[u] < distance[best])
+                    {
+                        best = u;
+                        tied[index] = 0;
+                    }
+                    else if(distance[u] == distance[best] && u != best)
+                    {
+                        tied[index] = 1;
+                    }
+                }
+                predecessor[index] = best;
+            }
+        };
+
+    int chunks = (n + deltaSteppingChunkSize - 1) / deltaSteppingChunkSize;
+    if(chunks <= 1)
+    {
+        choose(0, n);
+    }
+    else
+    {
+        pool.run(
+            chunks,
+            [&](int, int chunk)
+            {
+                int begin = chunk * deltaSteppingChunkSize;
+                choose(begin, std::min(n, begin + deltaSteppingChunkSize));
+            });
+    }
+
+    std::vector<double> plateaus;
+    for(int index = 0; index < n; index++)
+    {
+        if(tied[index])
+        {
+            plateaus.push_back(distance[predecessor[index]]);
+        }
+    }
+    if(plateaus.empty())
+    {
+        return;
+    }
+    std::sort(plateaus.begin(), plateaus.end());
+    plateaus.erase(std::unique(plateaus.begin(), plateaus.end()), plateaus.end());
+
+    // The vertices at one of those distances D come off a BinaryHeapQueue
+    // in order of index, except that one reached only along edges that add
+    // nothing to D (once rounded) from others at D isn't in the queue until
+    // one of those is settled.  So each of them is replayed on its own, and
+    // rank[i] records where the vertex at index i falls in its order.
+    std::vector<std::pair<double, int>> members;
+    for(int index = 0; index < n; index++)
+    {
+        if(std::binary_search(plateaus.begin(), plateaus.end(), distance[index]))
+        {
+            members.push_back(std::make_pair(distance[index], index));
+        }
+    }
+    std::sort(members.begin(), members.end());
+
+    const int waiting = -2;
+    const int queuedUp = -3;
+    std::vector<int> rank(n, -1);
+    std::priority_queue<int, std::vector<int>, std::greater<int>> available;
+    for(std::size_t first = 0, last = 0; first < members.size(); first = last)
+    {
+        double d = members[first].first;
+        while(last < members.size() && members[last].first == d)
+        {
+            rank[members[last++].second] = waiting;
+        }
+
+        for(std::size_t i = first; i < last; i++)
+        {
+            int index = members[i].second;
+            bool reached = index == tree.startIndex;
+            for(int r = reverseOffsets[index]; !reached && r < reverseOffsets[index + 1]; r++)
+            {
+                double du = distance[reverseSources[r]];
+                reached = du < d && du + weightAt(edgeWeightFunc, reverseEdges[r]) == d;
+            }
+            if(reached)
+            {
+                rank[index] = queuedUp;
+                available.push(index);
+            }
+        }
+
+        for(int next = 0; !available.empty(); next++)
+        {
+            int index = available.top();
+            available.pop();
+            rank[index] = next;
+            for(int edge = offsets[index]; edge < offsets[index + 1]; edge++)
+            {
+                if(rank[targets[edge]] == waiting && d + weightAt(edgeWeightFunc, edge) == d)
+                {
+                    rank[targets[edge]] = queuedUp;
+                    available.push(targets[edge]);
+                }
+            }
+        }
+    }
+
+    for(int index = 0; index < n; index++)
+    {
+        if(!tied[index])
+        {
+            continue;
+        }
+        double d = distance[predecessor[index]];
+        for(int r = reverseOffsets[index]; r < reverseOffsets[index + 1]; r++)
+        {
+            int u = reverseSources[r];
+            if(distance[u] == d && d + weightAt(edgeWeightFunc, reverseEdges[r]) == distance[index]
+                && rank[u] < rank[predecessor[index]])
+            {
+                predecessor[index] = u;
+            }
+        }
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename PriorityQueue, typename Stats>
+DigraphPath CompactDigraph<VertexInfo, EdgeInfo>::tracePath(
+    int start, int end, BasicDijkstraWorkspace<PriorityQueue, Stats>& workspace) const
+{
+    workspace.stats.startPaths();
+    DigraphPath path = tracePath(
+        start, end,
+        [&workspace](int index)
+        {
+            return workspace.predecessor(index);
+        },
+        [&workspace](int index)
+        {
+            return workspace.distance(index);
+        });
+    workspace.stats.stopPaths();
+    return path;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename PredecessorFunc, typename DistanceFunc>
+DigraphPath CompactDigraph<VertexInfo, EdgeInfo>::tracePath(
+    int start, int end, PredecessorFunc predecessor, DistanceFunc distance) const
+{
+    DigraphPath path{{}, distance(end), {}, {}};
+    if(end != start && predecessor(end) == -1)
+    {
+        path.cost = std::numeric_limits<double>::infinity();
+        return path;
+    }
+
+    for(int index = end; index != start; index = predecessor(index))
+    {
+        path.vertices.push_back(ids[index]);
+        path.edges.push_back(edgePosition(predecessor(index), index));
+        path.costs.push_back(distance(index));
+    }
+    path.vertices.push_back(ids[start]);
+    path.costs.push_back(distance(start));
+    std::reverse(path.vertices.begin(), path.vertices.end());
+    std::reverse(path.edges.begin(), path.edges.end());
+    std::reverse(path.costs.begin(), path.costs.end());
+    return path;
+}
+
+
+
+#endif // COMPACTDIGRAPH_HPP
+
@@ -0,0 +1,670 @@
+// ContractionHierarchy.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This header file declares a class template called ContractionHierarchy,
+// which preprocesses a CompactDigraph under one fixed edge weight function
+// so that shortest path queries against it can be answered by searching
+// only a tiny part of the graph.
+//
+// Preprocessing "contracts" the vertices one at a time, in an order chosen
+// so that unimportant vertices (e.g., a location on a quiet side street)
+// go first and important ones (e.g., a freeway interchange) go last.  The
+// position of a vertex in that order is its rank.  Contracting a vertex v
+// removes it from the graph that's left, and wherever a path u -> v -> x
+// was the only shortest path from u to x, a "shortcut" edge u -> x with the
+// same total weight is added to take its place.
+//
+// Afterward, every shortest path can be found by a bidirectional search in
+// which both halves only ever move to higher-ranked vertices: the forward
+// half along original or shortcut edges from the start vertex, and the
+// backward half backward along them from the end vertex.  Shortcuts
+// remember the two edges they replaced, so the path found can be unpacked
+// into the original vertices along it.
+//
+// Because the shortcuts depend on the edge weights, a ContractionHierarchy
+// answers queries for the weight function it was built with and no other.
+
+#ifndef CONTRACTIONHIERARCHY_HPP
+#define CONTRACTIONHIERARCHY_HPP
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "CompactDigraph.hpp"
+#include "DijkstraWorkspace.hpp"
+#include "DistanceMatrix.hpp"
+#include "ManyToManySearch.hpp"
+#include "WorkStealingPool.hpp"
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+class ContractionHierarchy
+{
+public:
+    // This constructor builds a ContractionHierarchy over the given graph,
+    // using the given function to determine the weight of each edge, in
+    // the same way that findShortestPaths() would.  The graph must outlive
+    // the ContractionHierarchy.
+    template <typename EdgeWeightFunc>
+    ContractionHierarchy(
+        const CompactDigraph<VertexInfo, EdgeInfo>& graph,
+        EdgeWeightFunc edgeWeightFunc);
+
+    // findShortestPath() returns a shortest path from the start vertex to
+    // the end vertex under the weight function the hierarchy was built
+    // with, as a sequence of vertices of the original graph.  When there
+    // are several shortest paths, the one chosen may differ from the one
+    // CompactDigraph::findShortestPath() would choose.  If either vertex
+    // does not exist, a DigraphException is thrown instead.
+    DigraphPath findShortestPath(int startVertex, int endVertex) const;
+
+    // This overload of findShortestPath() uses the given DijkstraWorkspaces
+    // as the scratch space of the forward and backward halves of the
+    // search; they must be two different workspaces, and can have any
+    // kind of priority queue.
+    template <typename PriorityQueue, typename Stats>
+    DigraphPath findShortestPath(
+        int startVertex, int endVertex,
+        BasicDijkstraWorkspace<PriorityQueue, Stats>& forward,
+        BasicDijkstraWorkspace<PriorityQueue, Stats>& backward) const;
+
+    // distanceMatrix() returns the cost of a shortest path from each of the
+    // given source vertices (the rows) to each of the given target vertices
+    // (the columns), infinite where there's none, by the bucket-based
+    // many-to-many search of ManyToManySearch.hpp, spread over the workers
+    // of the given WorkStealingPool.  If any of the vertices does not
+    // exist, a DigraphException is thrown instead.
+    DistanceMatrix distanceMatrix(
+        const std::vector<int>& sourceVertices,
+        const std::vector<int>& targetVertices,
+        WorkStealingPool& pool) const;
+
+    // rankOf() returns the position of the given vertex in the order in
+    // which vertices were contracted.  If the vertex does not exist, a
+    // DigraphException is thrown instead.
+    int rankOf(int vertex) const;
+
+    // shortcutCount() returns the number of shortcuts that preprocessing
+    // added to the graph.
+    int shortcutCount() const noexcept;
+
+
+private:
+    // An Arc is an edge of the hierarchy.  An arc standing for an edge of
+    // the original graph has that edge's position in edge; a shortcut has
+    // an edge of -1 instead, and first and second are the arcs it stands
+    // for, which meet at a lower-ranked vertex.
+    struct Arc
+    {
+        int from;
+        int to;
+        double weight;
+        int first;
+        int second;
+        int edge;
+    };
+
+    // A Shortcut is one that contracting some vertex would require: the
+    // arcs from and to that vertex that it would replace.
+    struct Shortcut
+    {
+        int first;
+        int second;
+    };
+
+    const CompactDigraph<VertexInfo, EdgeInfo>* graph;
+    std::vector<int> rank;
+    std::vector<Arc> arcs;
+    int shortcuts;
+
+    // the arcs leaving each vertex toward higher-ranked vertices, and the
+    // arcs entering each vertex from higher-ranked vertices, in CSR form
+    std::vector<int> upOffsets;
+    std::vector<int> upArcs;
+    std::vector<int> downOffsets;
+    std::vector<int> downArcs;
+
+    // The remaining members are only used while the hierarchy is being
+    // built: the arcs leaving and entering each vertex that's still in
+    // the graph, and scratch space for witness searches.
+    std::vector<std::vector<int>> outArcs;
+    std::vector<std::vector<int>> inArcs;
+    std::vector<bool> contracted;
+    std::vector<double> witnessDistance;
+    std::vector<int> witnessTouched;
+    std::vector<std::pair<double, int>> witnessHeap;
+
+    // a witness search gives up after settling this many vertices, in
+    // which case a shortcut is added even if it might not be needed
+    static constexpr int witnessSettleLimit = 64;
+
+    //contracts every vertex and builds the upward and downward arcs
+    void build();
+
+    //finds the shortcuts that contracting vertex v would need
+    void findShortcuts(int v, std::vector<Shortcut>& needed);
+
+    //removes vertex v from the remaining graph, adding the shortcuts
+    void contract(int v, const std::vector<Shortcut>& needed);
+
+    //returns the arc from u to x that's still in the graph, or -1
+    int findArc(int u, int x) const;
+
+    //appends the original vertices along an arc (except its first) to
+    //indices, and the original edges along it and their costs to path
+    void unpack(int arc, std::vector<int>& indices, DigraphPath& path) const;
+};
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+ContractionHierarchy<VertexInfo, EdgeInfo>::ContractionHierarchy(
+    const CompactDigraph<VertexInfo, EdgeInfo>& graph,
+    EdgeWeightFunc edgeWeightFunc)
+    : graph{&graph}, shortcuts{0}
+{
+    int n = graph.vertexCount();
+    outArcs.resize(n);
+    inArcs.resize(n);
+
+    // Self-loops are never part of a shortest path, so they're left out;
+    // there are no parallel edges, since a Digraph doesn't allow them.
+    arcs.reserve(graph.edgeCount());
+    for(int from = 0; from < n; from++)
+    {
+        for(int edge = graph.edgeBegin(from); edge < graph.edgeEnd(from); edge++)
+        {
+            int to = graph.edgeTarget(edge);
+            if(to != from)
+            {
+                int arc = static_cast<int>(arcs.size());
+                arcs.push_back(Arc{from, to, edgeWeightFunc(graph.edgeInfoAt(edge)), -1, -1, edge});
+                outArcs[from].push_back(arc);
+                inArcs[to].push_back(arc);
+            }
+        }
+    }
+
+    build();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphPath ContractionHierarchy<VertexInfo, EdgeInfo>::findShortestPath(
+    int startVertex, int endVertex) const
+{
+    DijkstraWorkspace forward;
+    DijkstraWorkspace backward;
+    return findShortestPath(startVertex, endVertex, forward, backward);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename PriorityQueue, typename Stats>
+DigraphPath ContractionHierarchy<VertexInfo, EdgeInfo>::findShortestPath(
+    int startVertex, int endVertex,
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& forward,
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& backward) const
+{
+    int n = graph->vertexCount();
+    int startIndex = graph->indexOf(startVertex);
+    int endIndex = graph->indexOf(endVertex);
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    if(startIndex == endIndex)
+    {
+        return DigraphPath{{startVertex}, 0, {}, {0}};
+    }
+
+    // The forward search (F) starts at the start vertex and follows the
+    // upward arcs; the backward search (B) starts at the end vertex and
+    // follows the downward arcs in reverse.  The predecessor recorded for
+    // each vertex is the arc by which it was reached.
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& F = forward;
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& B = backward;
+    F.reset(n);
+    B.reset(n);
+    F.stats.startSearch();
+    F.reach(startIndex, 0, -1);
+    B.reach(endIndex, 0, -1);
+
+    F.queue.push(startIndex, 0);
+    B.queue.push(endIndex, 0);
+    F.stats.countPush();
+    B.stats.countPush();
+
+    double best = infinity;
+    int meet = -1;
+
+    // Unlike an ordinary bidirectional search, neither half can stop when
+    // the two meet, because the shortest path runs up to its highest-ranked
+    // vertex from both ends; each half stops once it can't improve on best.
+    while(!F.queue.empty() || !B.queue.empty())
+    {
+        bool isForward = B.queue.empty()
+            || (!F.queue.empty() && F.queue.top().first <= B.queue.top().first);
+        BasicDijkstraWorkspace<PriorityQueue, Stats>& W = isForward ? F : B;
+        PriorityQueue& pq = W.queue;
+        const std::vector<int>& offsets = isForward ? upOffsets : downOffsets;
+        const std::vector<int>& adjacent = isForward ? upArcs : downArcs;
+
+        double d = pq.top().first;
+        int index = pq.top().second;
+        pq.pop();
+        W.stats.countPop();
+
+        if(d >= best)
+        {
+            pq.clear();
+            continue;
+        }
+        if(d > W.distance(index))
+        {
+            W.stats.countStalePop();
+            continue;
+        }
+        W.stats.countSettle();
+
+        if(F.distance(index) + B.distance(index) < best)
+        {
+            best = F.distance(index) + B.distance(index);
+            meet = index;
+        }
+
+        for(int i = offsets[index]; i < offsets[index + 1]; i++)
+        {
+            const Arc& arc = arcs[adjacent[i]];
+            int w = isForward ? arc.to : arc.from;
+            W.stats.countRelax();
+            if(W.distance(w) > d + arc.weight)
+            {
+                W.reach(w, d + arc.weight, adjacent[i]);
+                pq.push(w, d + arc.weight);
+                W.stats.countPush();
+            }
+        }
+    }
+
+    F.stats.stopSearch();
+
+    DigraphPath path{{}, infinity, {}, {}};
+    if(meet == -1)
+    {
+        return path;
+    }
+    F.stats.startPaths();
+    path.cost = best;
+
+    std::vector<int> chain;
+    for(int index = meet; index != startIndex; index = arcs[F.predecessor(index)].from)
+    {
+        chain.push_back(F.predecessor(index));
+    }
+    std::reverse(chain.begin(), chain.end());
+    for(int index = meet; index != endIndex; index = arcs[B.predecessor(index)].to)
+    {
+        chain.push_back(B.predecessor(index));
+    }
+
+    std::vector<int> vertices{startIndex};
+    path.costs.push_back(0);
+    for(int arc: chain)
+    {
+        unpack(arc, vertices, path);
+    }
+    path.vertices.reserve(vertices.size());
+    for(int index: vertices)
+    {
+        path.vertices.push_back(graph->vertexAt(index));
+    }
+    F.stats.stopPaths();
+    return path;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DistanceMatrix ContractionHierarchy<VertexInfo, EdgeInfo>::distanceMatrix(
+    const std::vector<int>& sourceVertices,
+    const std::vector<int>& targetVertices,
+    WorkStealingPool& pool) const
+{
+    std::vector<int> sources;
+    std::vector<int> targets;
+    sources.reserve(sourceVertices.size());
+    targets.reserve(targetVertices.size());
+    for(int vertex: sourceVertices)
+    {
+        sources.push_back(graph->indexOf(vertex));
+    }
+    for(int vertex: targetVertices)
+    {
+        targets.push_back(graph->indexOf(vertex));
+    }
+
+    return findManyToManyDistances(
+        graph->vertexCount(), sources, targets,
+        [this](int index, auto relax)
+        {
+            for(int i = upOffsets[index]; i < upOffsets[index + 1]; i++)
+            {
+                const Arc& arc = arcs[upArcs[i]];
+                relax(arc.to, arc.weight);
+            }
+        },
+        [this](int index, auto relax)
+        {
+            for(int i = downOffsets[index]; i < downOffsets[index + 1]; i++)
+            {
+                const Arc& arc = arcs[downArcs[i]];
+                relax(arc.from, arc.weight);
+            }
+        },
+        pool);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int ContractionHierarchy<VertexInfo, EdgeInfo>::rankOf(int vertex) const
+{
+    return rank[graph->indexOf(vertex)];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int ContractionHierarchy<VertexInfo, EdgeInfo>::shortcutCount() const noexcept
+{
+    return shortcuts;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void ContractionHierarchy<VertexInfo, EdgeInfo>::build()
+{
+    int n = graph->vertexCount();
+    rank.assign(n, -1);
+    contracted.assign(n, false);
+    witnessDistance.assign(n, std::numeric_limits<double>::infinity());
+
+    // A vertex's priority is its edge difference (the shortcuts contracting
+    // it would add, less the arcs it would remove) plus the number of its
+    // neighbors already contracted, which spreads contraction evenly over
+    // the graph.  Priorities are only brought up to date when a vertex
+    // reaches the front of the queue.
+    std::vector<int> contractedNeighbors(n, 0);
+    std::vector<Shortcut> needed;
+
+    auto priority =
+        [&](int v)
+        {
+            findShortcuts(v, needed);
+            int removed = 0;
+            for(int arc: outArcs[v])
+            {
+                removed += contracted[arcs[arc].to] ? 0 : 1;
+            }
+            for(int arc: inArcs[v])
+            {
+                removed += contracted[arcs[arc].from] ? 0 : 1;
+            }
+            return static_cast<int>(needed.size()) - removed + contractedNeighbors[v];
+        };
+
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> pq;
+    for(int v = 0; v < n; v++)
+    {
+        pq.push(std::make_pair(priority(v), v));
+    }
+
+    int order = 0;
+    while(!pq.empty())
+    {
+        int v = pq.top().second;
+        pq.pop();
+
+        int p = priority(v);
+        if(!pq.empty() && p > pq.top().first)
+        {
+            pq.push(std::make_pair(p, v));
+            continue;
+        }
+
+        for(int arc: outArcs[v])
+        {
+            contractedNeighbors[arcs[arc].to]++;
+        }
+        for(int arc: inArcs[v])
+        {
+            contractedNeighbors[arcs[arc].from]++;
+        }
+        contract(v, needed);
+        rank[v] = order++;
+    }
+
+    // Every arc now points either up or down the hierarchy; sort them into
+    // CSR arrays by the vertex each search would be at when following them.
+    upOffsets.assign(n + 1, 0);
+    downOffsets.assign(n + 1, 0);
+    for(const Arc& arc: arcs)
+    {
+        if(rank[arc.from] < rank[arc.to])
+        {
+            upOffsets[arc.from + 1]++;
+        }
+        else
+        {
+            downOffsets[arc.to + 1]++;
+        }
+    }
+    for(int i = 0; i < n; i++)
+    {
+        upOffsets[i + 1] += upOffsets[i];
+        downOffsets[i + 1] += downOffsets[i];
+    }
+    upArcs.resize(upOffsets[n]);
+    downArcs.resize(downOffsets[n]);
+    std::vector<int> nextUp(upOffsets.begin(), upOffsets.end() - 1);
+    std::vector<int> nextDown(downOffsets.begin(), downOffsets.end() - 1);
+    for(int arc = 0; arc < static_cast<int>(arcs.size()); arc++)
+    {
+        if(rank[arcs[arc].from] < rank[arcs[arc].to])
+        {
+            upArcs[nextUp[arcs[arc].from]++] = arc;
+        }
+        else
+        {
+            downArcs[nextDown[arcs[arc].to]++] = arc;
+        }
+    }
+
+    outArcs = std::vector<std::vector<int>>{};
+    inArcs = std::vector<std::vector<int>>{};
+    contracted = std::vector<bool>{};
+    witnessDistance = std::vector<double>{};
+    witnessTouched = std::vector<int>{};
+    witnessHeap = std::vector<std::pair<double, int>>{};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void ContractionHierarchy<VertexInfo, EdgeInfo>::findShortcuts(int v, std::vector<Shortcut>& needed)
+{
+    needed.clear();
+
+    for(int first: inArcs[v])
+    {
+        int u = arcs[first].from;
+        if(contracted[u])
+        {
+            continue;
+        }
+
+        double limit = 0;
+        for(int second: outArcs[v])
+        {
+            int x = arcs[second].to;
+            if(!contracted[x] && x != u)
+            {
+                limit = std::max(limit, arcs[first].weight + arcs[second].weight);
+            }
+        }
+
+        // The witness search is a Dijkstra search from u that avoids v; any
+        // x it reaches at least as cheaply as through v needs no shortcut.
+        // Its heap lives in witnessHeap, so searches don't reallocate it.
+        std::greater<std::pair<double, int>> later;
+        witnessHeap.clear();
+        witnessDistance[u] = 0;
+        witnessTouched.push_back(u);
+        witnessHeap.push_back(std::make_pair(0, u));
+        int settled = 0;
+        while(!witnessHeap.empty() && settled < witnessSettleLimit)
+        {
+            std::pop_heap(witnessHeap.begin(), witnessHeap.end(), later);
+            double d = witnessHeap.back().first;
+            int w = witnessHeap.back().second;
+            witnessHeap.pop_back();
+
+            if(d > limit)
+            {
+                break;
+            }
+            if(d > witnessDistance[w])
+            {
+                continue;
+            }
+            settled++;
+
+            for(int arc: outArcs[w])
+            {
+                int y = arcs[arc].to;
+                if(y != v && !contracted[y] && witnessDistance[y] > d + arcs[arc].weight)
+                {
+                    if(witnessDistance[y] == std::numeric_limits<double>::infinity())
+                    {
+                        witnessTouched.push_back(y);
+                    }
+                    witnessDistance[y] = d + arcs[arc].weight;
+                    witnessHeap.push_back(std::make_pair(witnessDistance[y], y));
+                    std::push_heap(witnessHeap.begin(), witnessHeap.end(), later);
+                }
+            }
+        }
+
+        for(int second: outArcs[v])
+        {
+            int x = arcs[second].to;
+            if(!contracted[x] && x != u
+               && witnessDistance[x] > arcs[first].weight + arcs[second].weight)
+            {
+                needed.push_back(Shortcut{first, second});
+            }
+        }
+
+        for(int w: witnessTouched)
+        {
+            witnessDistance[w] = std::numeric_limits<double>::infinity();
+        }
+        witnessTouched.clear();
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void ContractionHierarchy<VertexInfo, EdgeInfo>::contract(int v, const std::vector<Shortcut>& needed)
+{
+    contracted[v] = true;
+
+    // The neighbors of v no longer need their arcs to and from it (the
+    // arcs themselves stay in arcs, for the hierarchy and for unpacking).
+    auto through =
+        [this, v](int arc)
+        {
+            return arcs[arc].from == v || arcs[arc].to == v;
+        };
+    for(int arc: inArcs[v])
+    {
+        std::vector<int>& out = outArcs[arcs[arc].from];
+        out.erase(std::remove_if(out.begin(), out.end(), through), out.end());
+    }
+    for(int arc: outArcs[v])
+    {
+        std::vector<int>& in = inArcs[arcs[arc].to];
+        in.erase(std::remove_if(in.begin(), in.end(), through), in.end());
+    }
+
+    for(const Shortcut& shortcut: needed)
+    {
+        int u = arcs[shortcut.first].from;
+        int x = arcs[shortcut.second].to;
+        double weight = arcs[shortcut.first].weight + arcs[shortcut.second].weight;
+
+        // An arc from u to x that's still in the graph isn't part of any
+        // shortcut yet (those all pass through contracted vertices), so it
+        // can simply be replaced if the shortcut is cheaper.
+        int existing = findArc(u, x);
+        if(existing != -1)
+        {
+            if(arcs[existing].weight > weight)
+            {
+                arcs[existing] = Arc{u, x, weight, shortcut.first, shortcut.second, -1};
+            }
+            continue;
+        }
+
+        int arc = static_cast<int>(arcs.size());
+        arcs.push_back(Arc{u, x, weight, shortcut.first, shortcut.second, -1});
+        outArcs[u].push_back(arc);
+        inArcs[x].push_back(arc);
+        shortcuts++;
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int ContractionHierarchy<VertexInfo, EdgeInfo>::findArc(int u, int x) const
+{
+    for(int arc: outArcs[u])
+    {
+        if(arcs[arc].to == x)
+        {
+            return arc;
+        }
+    }
+    return -1;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void ContractionHierarchy<VertexInfo, EdgeInfo>::unpack(
+    int arc, std::vector<int>& indices, DigraphPath& path) const
+{
+    std::vector<int> stack{arc};
+    while(!stack.empty())
+    {
+        const Arc& a = arcs[stack.back()];
+        stack.pop_back();
+        if(a.edge != -1)
+        {
+            indices.push_back(a.to);
+            path.edges.push_back(a.edge);
+            path.costs.push_back(path.costs.back() + a.weight);
+        }
+        else
+        {
+            stack.push_back(a.second);
+            stack.push_back(a.first);
+        }
+    }
+}
+
+
+
+#endif // CONTRACTIONHIERARCHY_HPP
+
@@ -0,0 +1,179 @@
+// CopyOnWrite.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This header file declares a class template called CopyOnWrite, which
+// holds a value (e.g., a std::vector) that's shared, rather than copied,
+// when the CopyOnWrite is copied, so copying one takes constant time no
+// matter how big the value is.  Reading the value goes straight to the
+// shared one; writing it first takes a private copy, unless no other
+// CopyOnWrite shares it, so a change made through one copy is never seen
+// through another.
+//
+// A Digraph keeps its parts in CopyOnWrites, which is what lets a copy of
+// a Digraph (e.g., a "what-if" scenario with one bridge closed) share
+// everything with the original except the parts it goes on to change.
+//
+// Like the containers it holds, a CopyOnWrite can be read by any number of
+// threads at once, but while it's being written, no other thread can touch
+// it (including to copy it).  Copies that share a value are separate
+// CopyOnWrites, though, so different threads can write them at once.
+
+#ifndef COPYONWRITE_HPP
+#define COPYONWRITE_HPP
+
+#include <atomic>
+#include <utility>
+
+
+
+template <typename T>
+class CopyOnWrite
+{
+public:
+    // The default constructor initializes a CopyOnWrite holding a
+    // value-initialized T, which isn't allocated until it's written.
+    CopyOnWrite() noexcept = default;
+
+    // This constructor initializes a CopyOnWrite holding the given value.
+    explicit CopyOnWrite(T value);
+
+    // Copying a CopyOnWrite shares its value; moving one takes its value
+    // away, leaving it holding a value-initialized T.
+    CopyOnWrite(const CopyOnWrite& other) noexcept;
+    CopyOnWrite(CopyOnWrite&& other) noexcept;
+    ~CopyOnWrite() noexcept;
+    CopyOnWrite& operator=(const CopyOnWrite& other) noexcept;
+    CopyOnWrite& operator=(CopyOnWrite&& other) noexcept;
+
+    // read() returns the value, which may be shared with other copies.
+    const T& read() const noexcept;
+
+    // write() returns the value, having first made a private copy of it
+    // if it's shared with any other CopyOnWrite.
+    T& write();
+
+private:
+    // A Shared is a value along with the number of CopyOnWrites that
+    // share it.  (A std::shared_ptr would count them too, but its
+    // use_count() is only a relaxed load, so seeing 1 there doesn't mean
+    // that another thread's last reads of the value have finished.  Here,
+    // the count is loaded with acquire, and each owner that lets go of the
+    // value releases it.)
+    struct Shared
+    {
+        explicit Shared(T value);
+
+        std::atomic<long> owners;
+        T value;
+    };
+
+    // the shared value, or nullptr for a value-initialized one (which is
+    // also what's left behind when a CopyOnWrite is moved from)
+    Shared* shared = nullptr;
+
+    //lets go of the shared value, destroying it if no one else shares it
+    void release() noexcept;
+};
+
+
+
+template <typename T>
+CopyOnWrite<T>::Shared::Shared(T value)
+    : owners{1}, value{std::move(value)}
+{
+}
+
+
+template <typename T>
+CopyOnWrite<T>::CopyOnWrite(T value)
+    : shared{new Shared{std::move(value)}}
+{
+}
+
+
+template <typename T>
+CopyOnWrite<T>::CopyOnWrite(const CopyOnWrite& other) noexcept
+    : shared{other.shared}
+{
+    if(shared != nullptr)
+    {
+        shared->owners.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+template <typename T>
+CopyOnWrite<T>::CopyOnWrite(CopyOnWrite&& other) noexcept
+    : shared{std::exchange(other.shared, nullptr)}
+{
+}
+
+
+template <typename T>
+CopyOnWrite<T>::~CopyOnWrite() noexcept
+{
+    release();
+}
+
+
+template <typename T>
+CopyOnWrite<T>& CopyOnWrite<T>::operator=(const CopyOnWrite& other) noexcept
+{
+    CopyOnWrite copy{other};
+    std::swap(shared, copy.shared);
+    return *this;
+}
+
+
+template <typename T>
+CopyOnWrite<T>& CopyOnWrite<T>::operator=(CopyOnWrite&& other) noexcept
+{
+    if(this != &other)
+    {
+        release();
+        shared = std::exchange(other.shared, nullptr);
+    }
+    return *this;
+}
+
+
+template <typename T>
+const T& CopyOnWrite<T>::read() const noexcept
+{
+    static const T empty{};
+    return shared != nullptr ? shared->value : empty;
+}
+
+
+template <typename T>
+T& CopyOnWrite<T>::write()
+{
+    if(shared == nullptr)
+    {
+        shared = new Shared{T{}};
+    }
+    else if(shared->owners.load(std::memory_order_acquire) != 1)
+    {
+        Shared* copy = new Shared{shared->value};
+        release();
+        shared = copy;
+    }
+    return shared->value;
+}
+
+
+template <typename T>
+void CopyOnWrite<T>::release() noexcept
+{
+    if(shared != nullptr && shared->owners.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete shared;
+    }
+    shared = nullptr;
+}
+
+
+
+#endif // COPYONWRITE_HPP
@@ -0,0 +1,777 @@
+// CustomizableContractionHierarchy.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This header file declares a class template called
+// CustomizableContractionHierarchy, which, like a ContractionHierarchy,
+// answers shortest path queries against a CompactDigraph by searching only
+// a tiny part of it, but splits preprocessing into two phases so that the
+// edge weights can change without starting over.
+//
+// The first phase depends only on which edges there are, not on their
+// weights.  It orders the vertices by nested dissection: it cuts the graph
+// in two with a small set of separator vertices, ranks the separator above
+// both halves, and cuts each half the same way.  It then contracts the
+// vertices in that order without any witness searches, so every shortcut
+// that could ever be needed is added, whatever the weights turn out to be.
+// Contracting a vertex connects all of its higher-ranked neighbors to each
+// other; each such arc between vertices x and y goes through a triangle
+// with every lower-ranked vertex that was adjacent to both.
+//
+// The second phase, customize(), gives every arc its weight in each
+// direction under some edge weight function: the weight of the original
+// edge, if there is one, improved by the cheapest detour through each of
+// its lower triangles.  It takes time linear in the number of triangles,
+// and can be spread over the workers of a WorkStealingPool, since arcs
+// whose lower vertex is at the same level of the hierarchy don't depend on
+// one another.  Customizing again, with new weights (e.g., from a newer
+// LiveRoadMap snapshot), is all it takes to bring the hierarchy up to date.
+//
+// Queries are the same bidirectional upward searches that a
+// ContractionHierarchy uses, and a whole matrix of distances is found by
+// the same many-to-many search.
+
+#ifndef CUSTOMIZABLECONTRACTIONHIERARCHY_HPP
+#define CUSTOMIZABLECONTRACTIONHIERARCHY_HPP
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "CompactDigraph.hpp"
+#include "DijkstraWorkspace.hpp"
+#include "DistanceMatrix.hpp"
+#include "ManyToManySearch.hpp"
+#include "VertexOrder.hpp"
+#include "WorkStealingPool.hpp"
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+class CustomizableContractionHierarchy
+{
+public:
+    // This constructor runs the first phase of preprocessing over the given
+    // graph, which is copied (cheaply, since a CompactDigraph shares its
+    // arrays).  No path is found until customize() has been called.
+    explicit CustomizableContractionHierarchy(const CompactDigraph<VertexInfo, EdgeInfo>& graph);
+
+    // This constructor runs both phases, customizing the hierarchy with the
+    // given weight function.
+    template <typename EdgeWeightFunc>
+    CustomizableContractionHierarchy(
+        const CompactDigraph<VertexInfo, EdgeInfo>& graph,
+        EdgeWeightFunc edgeWeightFunc);
+
+    // customize() recomputes the weight of every arc from the EdgeInfo
+    // objects of the given graph, using the given function to determine
+    // the weight of each edge, in the same way that findShortestPaths()
+    // would.  The graph must have exactly the same vertices and edges as
+    // the one the hierarchy was built over (e.g., a later snapshot of the
+    // same LiveRoadMap); otherwise, a DigraphException is thrown and the
+    // hierarchy is left as it was.  Paths returned afterward are made of
+    // the given graph's vertices and weights.
+    template <typename EdgeWeightFunc>
+    void customize(
+        const CompactDigraph<VertexInfo, EdgeInfo>& graph,
+        EdgeWeightFunc edgeWeightFunc);
+
+    // This overload of customize() spreads the work over the workers of the
+    // given WorkStealingPool.  The result is the same.
+    template <typename EdgeWeightFunc>
+    void customize(
+        const CompactDigraph<VertexInfo, EdgeInfo>& graph,
+        EdgeWeightFunc edgeWeightFunc,
+        WorkStealingPool& pool);
+
+    // findShortestPath() returns a shortest path from the start vertex to
+    // the end vertex under the weight function of the last customization,
+    // as a sequence of vertices of the original graph.  When there are
+    // several shortest paths, the one chosen may differ from the one
+    // CompactDigraph::findShortestPath() would choose.  If either vertex
+    // does not exist, a DigraphException is thrown instead.
+    DigraphPath findShortestPath(int startVertex, int endVertex) const;
+
+    // This overload of findShortestPath() uses the given DijkstraWorkspaces
+    // as the scratch space of the forward and backward halves of the
+    // search; they must be two different workspaces, and can have any
+    // kind of priority queue.
+    template <typename PriorityQueue, typename Stats>
+    DigraphPath findShortestPath(
+        int startVertex, int endVertex,
+        BasicDijkstraWorkspace<PriorityQueue, Stats>& forward,
+        BasicDijkstraWorkspace<PriorityQueue, Stats>& backward) const;
+
+    // distanceMatrix() returns the cost of a shortest path from each of the
+    // given source vertices (the rows) to each of the given target vertices
+    // (the columns) under the weight function of the last customization,
+    // infinite where there's none, by the bucket-based many-to-many search
+    // of ManyToManySearch.hpp, spread over the workers of the given
+    // WorkStealingPool.  If any of the vertices does not exist, a
+    // DigraphException is thrown instead.
+    DistanceMatrix distanceMatrix(
+        const std::vector<int>& sourceVertices,
+        const std::vector<int>& targetVertices,
+        WorkStealingPool& pool) const;
+
+    // rankOf() returns the position of the given vertex in the nested
+    // dissection order.  If the vertex does not exist, a DigraphException
+    // is thrown instead.
+    int rankOf(int vertex) const;
+
+    // arcCount() returns the number of arcs in the hierarchy, and
+    // shortcutCount() the number of them that stand for no edge of the
+    // original graph in either direction.
+    int arcCount() const noexcept;
+    int shortcutCount() const noexcept;
+
+    // triangleCount() returns the number of lower triangles, which is the
+    // amount of work that customize() does.
+    int triangleCount() const noexcept;
+
+
+private:
+    // A Triangle of an arc between x and y is the two arcs, lower and
+    // upper, that connect a lower-ranked vertex v to x and to y.
+    struct Triangle
+    {
+        int lower;
+        int upper;
+    };
+
+    CompactDigraph<VertexInfo, EdgeInfo> graph;
+    int shortcuts;
+
+    // rank -> index, and index -> rank
+    std::vector<int> order;
+    std::vector<int> rank;
+
+    // the arcs leaving each rank toward higher ranks, in CSR form and in
+    // increasing order of their heads; tails[arc] is the rank they leave
+    std::vector<int> arcOffsets;
+    std::vector<int> heads;
+    std::vector<int> tails;
+
+    // the lower triangles of each arc, in CSR form
+    std::vector<int> triangleOffsets;
+    std::vector<Triangle> triangles;
+
+    // the ranks at each level, in CSR form: every arc leaving a rank at
+    // one level only has triangles through ranks at lower levels
+    std::vector<int> levelOffsets;
+    std::vector<int> levelRanks;
+
+    // The customized weight of each arc going up (from its tail to its
+    // head) and down (from its head to its tail), along with the triangle
+    // whose detour it stands for, or -1 if it stands for an original edge.
+    // Every weight is infinite until the hierarchy has been customized.
+    std::vector<double> upWeights;
+    std::vector<double> downWeights;
+    std::vector<int> upTriangles;
+    std::vector<int> downTriangles;
+
+    // vertices are assigned their nested dissection order in parts of at
+    // most this many, and customization hands workers this many ranks at
+    // a time
+    static constexpr int dissectionLeafSize = 32;
+    static constexpr int customizationChunkSize = 256;
+
+    //orders the vertices by nested dissection (see VertexOrder.hpp)
+    void orderVertices();
+
+    //adds the arcs needed to contract the vertices in order
+    void buildArcs();
+
+    //finds the lower triangles of every arc, and the level of every rank
+    void buildTriangles();
+
+    //returns true if the given graph has the same vertices and edges
+    bool sameTopology(const CompactDigraph<VertexInfo, EdgeInfo>& other) const;
+
+    //returns the arc from rank x up to rank y, or -1
+    int findArc(int x, int y) const noexcept;
+
+    //runs the second phase, using the pool if there is one
+    template <typename EdgeWeightFunc>
+    void runCustomization(
+        const CompactDigraph<VertexInfo, EdgeInfo>& other,
+        EdgeWeightFunc edgeWeightFunc,
+        WorkStealingPool* pool);
+
+    //appends the original vertices along an arc (except its first) to
+    //indices, and the original edges along it and their costs to path
+    void unpack(int arc, bool up, std::vector<int>& indices, DigraphPath& path) const;
+};
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::CustomizableContractionHierarchy(
+    const CompactDigraph<VertexInfo, EdgeInfo>& graph)
+    : graph{graph}, shortcuts{0}
+{
+    orderVertices();
+    buildArcs();
+    buildTriangles();
+
+    int arcs = arcCount();
+    upWeights.assign(arcs, std::numeric_limits<double>::infinity());
+    downWeights.assign(arcs, std::numeric_limits<double>::infinity());
+    upTriangles.assign(arcs, -1);
+    downTriangles.assign(arcs, -1);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::CustomizableContractionHierarchy(
+    const CompactDigraph<VertexInfo, EdgeInfo>& graph,
+    EdgeWeightFunc edgeWeightFunc)
+    : CustomizableContractionHierarchy{graph}
+{
+    runCustomization(graph, edgeWeightFunc, nullptr);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+void CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::customize(
+    const CompactDigraph<VertexInfo, EdgeInfo>& graph,
+    EdgeWeightFunc edgeWeightFunc)
+{
+    runCustomization(graph, edgeWeightFunc, nullptr);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+void CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::customize(
+    const CompactDigraph<VertexInfo, EdgeInfo>& graph,
+    EdgeWeightFunc edgeWeightFunc,
+    WorkStealingPool& pool)
+{
+    runCustomization(graph, edgeWeightFunc, &pool);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphPath CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::findShortestPath(
+    int startVertex, int endVertex) const
+{
+    DijkstraWorkspace forward;
+    DijkstraWorkspace backward;
+    return findShortestPath(startVertex, endVertex, forward, backward);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename PriorityQueue, typename Stats>
+DigraphPath CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::findShortestPath(
+    int startVertex, int endVertex,
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& forward,
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& backward) const
+{
+    int n = graph.vertexCount();
+    int startRank = rank[graph.indexOf(startVertex)];
+    int endRank = rank[graph.indexOf(endVertex)];
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    if(startRank == endRank)
+    {
+        return DigraphPath{{startVertex}, 0, {}, {0}};
+    }
+
+    // Both halves follow the arcs up from the rank they're at: the forward
+    // search (F) from the start vertex by their upward weights, and the
+    // backward search (B) from the end vertex by their downward weights.
+    // The predecessor recorded for each rank is the arc by which it was
+    // reached, and arcs that haven't any weight yet are never followed.
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& F = forward;
+    BasicDijkstraWorkspace<PriorityQueue, Stats>& B = backward;
+    F.reset(n);
+    B.reset(n);
+    F.stats.startSearch();
+    F.reach(startRank, 0, -1);
+    B.reach(endRank, 0, -1);
+
+    F.queue.push(startRank, 0);
+    B.queue.push(endRank, 0);
+    F.stats.countPush();
+    B.stats.countPush();
+
+    double best = infinity;
+    int meet = -1;
+
+    while(!F.queue.empty() || !B.queue.empty())
+    {
+        bool isForward = B.queue.empty()
+            || (!F.queue.empty() && F.queue.top().first <= B.queue.top().first);
+        BasicDijkstraWorkspace<PriorityQueue, Stats>& W = isForward ? F : B;
+        PriorityQueue& pq = W.queue;
+        const std::vector<double>& weights = isForward ? upWeights : downWeights;
+
+        double d = pq.top().first;
+        int r = pq.top().second;
+        pq.pop();
+        W.stats.countPop();
+
+        if(d >= best)
+        {
+            pq.clear();
+            continue;
+        }
+        if(d > W.distance(r))
+        {
+            W.stats.countStalePop();
+            continue;
+        }
+        W.stats.countSettle();
+
+        if(F.distance(r) + B.distance(r) < best)
+        {
+            best = F.distance(r) + B.distance(r);
+            meet = r;
+        }
+
+        for(int arc = arcOffsets[r]; arc < arcOffsets[r + 1]; arc++)
+        {
+            int h = heads[arc];
+            W.stats.countRelax();
+            if(W.distance(h) > d + weights[arc])
+            {
+                W.reach(h, d + weights[arc], arc);
+                pq.push(h, d + weights[arc]);
+                W.stats.countPush();
+            }
+        }
+    }
+
+    F.stats.stopSearch();
+
+    DigraphPath path{{}, infinity, {}, {}};
+    if(meet == -1)
+    {
+        return path;
+    }
+    F.stats.startPaths();
+    path.cost = best;
+
+    std::vector<int> chain;
+    for(int r = meet; r != startRank; r = tails[F.predecessor(r)])
+    {
+        chain.push_back(F.predecessor(r));
+    }
+    std::reverse(chain.begin(), chain.end());
+    int upCount = static_cast<int>(chain.size());
+    for(int r = meet; r != endRank; r = tails[B.predecessor(r)])
+    {
+        chain.push_back(B.predecessor(r));
+    }
+
+    std::vector<int> indices{order[startRank]};
+    path.costs.push_back(0);
+    for(int i = 0; i < static_cast<int>(chain.size()); i++)
+    {
+        unpack(chain[i], i < upCount, indices, path);
+    }
+    path.vertices.reserve(indices.size());
+    for(int index: indices)
+    {
+        path.vertices.push_back(graph.vertexAt(index));
+    }
+    F.stats.stopPaths();
+    return path;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DistanceMatrix CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::distanceMatrix(
+    const std::vector<int>& sourceVertices,
+    const std::vector<int>& targetVertices,
+    WorkStealingPool& pool) const
+{
+    std::vector<int> sources;
+    std::vector<int> targets;
+    sources.reserve(sourceVertices.size());
+    targets.reserve(targetVertices.size());
+    for(int vertex: sourceVertices)
+    {
+        sources.push_back(rank[graph.indexOf(vertex)]);
+    }
+    for(int vertex: targetVertices)
+    {
+        targets.push_back(rank[graph.indexOf(vertex)]);
+    }
+
+    // Both phases follow the arcs up from each rank, by their upward
+    // weights from the sources and by their downward weights from the
+    // targets.
+    return findManyToManyDistances(
+        graph.vertexCount(), sources, targets,
+        [this](int r, auto relax)
+        {
+            for(int arc = arcOffsets[r]; arc < arcOffsets[r + 1]; arc++)
+            {
+                relax(heads[arc], upWeights[arc]);
+            }
+        },
+        [this](int r, auto relax)
+        {
+            for(int arc = arcOffsets[r]; arc < arcOffsets[r + 1]; arc++)
+            {
+                relax(heads[arc], downWeights[arc]);
+            }
+        },
+        pool);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::rankOf(int vertex) const
+{
+    return rank[graph.indexOf(vertex)];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::arcCount() const noexcept
+{
+    return static_cast<int>(heads.size());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::shortcutCount() const noexcept
+{
+    return shortcuts;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::triangleCount() const noexcept
+{
+    return static_cast<int>(triangles.size());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::orderVertices()
+{
+    order = nestedDissectionOrder(graph, dissectionLeafSize);
+    rank.assign(order.size(), -1);
+    for(int r = 0; r < static_cast<int>(order.size()); r++)
+    {
+        rank[order[r]] = r;
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::buildArcs()
+{
+    int n = graph.vertexCount();
+
+    // up[r] collects the higher ranks adjacent to rank r.  Self-loops are
+    // never part of a shortest path, so they're left out.
+    std::vector<std::vector<int>> up(n);
+    for(int from = 0; from < n; from++)
+    {
+        for(int edge = graph.edgeBegin(from); edge < graph.edgeEnd(from); edge++)
+        {
+            int r1 = rank[from];
+            int r2 = rank[graph.edgeTarget(edge)];
+            if(r1 != r2)
+            {
+                up[std::min(r1, r2)].push_back(std::max(r1, r2));
+            }
+        }
+    }
+
+    int originals = 0;
+    for(std::vector<int>& adjacent: up)
+    {
+        std::sort(adjacent.begin(), adjacent.end());
+        adjacent.erase(std::unique(adjacent.begin(), adjacent.end()), adjacent.end());
+        originals += static_cast<int>(adjacent.size());
+    }
+
+    // Contracting the ranks in order connects each one's higher neighbors
+    // to each other.  They're all adjacent to the lowest of them, which is
+    // contracted before the rest, so it's enough to pass the rest on to it.
+    arcOffsets.assign(n + 1, 0);
+    for(int r = 0; r < n; r++)
+    {
+        std::vector<int>& adjacent = up[r];
+        std::sort(adjacent.begin(), adjacent.end());
+        adjacent.erase(std::unique(adjacent.begin(), adjacent.end()), adjacent.end());
+        if(adjacent.size() > 1)
+        {
+            std::vector<int>& lowest = up[adjacent[0]];
+            lowest.insert(lowest.end(), adjacent.begin() + 1, adjacent.end());
+        }
+        arcOffsets[r + 1] = arcOffsets[r] + static_cast<int>(adjacent.size());
+    }
+
+    heads.resize(arcOffsets[n]);
+    tails.resize(arcOffsets[n]);
+    for(int r = 0; r < n; r++)
+    {
+        std::copy(up[r].begin(), up[r].end(), heads.begin() + arcOffsets[r]);
+        std::fill(tails.begin() + arcOffsets[r], tails.begin() + arcOffsets[r + 1], r);
+        up[r] = std::vector<int>{};
+    }
+
+    shortcuts = arcOffsets[n] - originals;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::buildTriangles()
+{
+    int n = graph.vertexCount();
+    int arcs = arcCount();
+
+    // Every pair of arcs leaving the same rank v, to x and to y (x < y),
+    // is a lower triangle of the arc from x to y.  They're found twice:
+    // once to count them and once to sort them into place.
+    triangleOffsets.assign(arcs + 1, 0);
+    for(int v = 0; v < n; v++)
+    {
+        for(int lower = arcOffsets[v]; lower < arcOffsets[v + 1]; lower++)
+        {
+            for(int upper = lower + 1; upper < arcOffsets[v + 1]; upper++)
+            {
+                triangleOffsets[findArc(heads[lower], heads[upper]) + 1]++;
+            }
+        }
+    }
+    for(int arc = 0; arc < arcs; arc++)
+    {
+        triangleOffsets[arc + 1] += triangleOffsets[arc];
+    }
+
+    triangles.resize(triangleOffsets[arcs]);
+    std::vector<int> next(triangleOffsets.begin(), triangleOffsets.end() - 1);
+    for(int v = 0; v < n; v++)
+    {
+        for(int lower = arcOffsets[v]; lower < arcOffsets[v + 1]; lower++)
+        {
+            for(int upper = lower + 1; upper < arcOffsets[v + 1]; upper++)
+            {
+                triangles[next[findArc(heads[lower], heads[upper])]++] = Triangle{lower, upper};
+            }
+        }
+    }
+
+    // A rank's level is one more than the highest level of the ranks below
+    // it that it's adjacent to, so all of its triangles go through ranks at
+    // lower levels.
+    std::vector<int> level(n, 0);
+    int levels = n > 0 ? 1 : 0;
+    for(int v = 0; v < n; v++)
+    {
+        for(int arc = arcOffsets[v]; arc < arcOffsets[v + 1]; arc++)
+        {
+            level[heads[arc]] = std::max(level[heads[arc]], level[v] + 1);
+            levels = std::max(levels, level[v] + 2);
+        }
+    }
+
+    levelOffsets.assign(levels + 1, 0);
+    for(int r = 0; r < n; r++)
+    {
+        levelOffsets[level[r] + 1]++;
+    }
+    for(int i = 0; i < levels; i++)
+    {
+        levelOffsets[i + 1] += levelOffsets[i];
+    }
+    levelRanks.resize(n);
+    std::vector<int> nextRank(levelOffsets.begin(), levelOffsets.end() - 1);
+    for(int r = 0; r < n; r++)
+    {
+        levelRanks[nextRank[level[r]]++] = r;
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+bool CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::sameTopology(
+    const CompactDigraph<VertexInfo, EdgeInfo>& other) const
+{
+    if(other.vertexCount() != graph.vertexCount() || other.edgeCount() != graph.edgeCount())
+    {
+        return false;
+    }
+
+    // Snapshots of the same LiveRoadMap share their arrays, so there's
+    // usually no need to compare them.
+    CompactDigraphArrays<VertexInfo, EdgeInfo> mine = graph.arrays();
+    CompactDigraphArrays<VertexInfo, EdgeInfo> theirs = other.arrays();
+    if(mine.ids.data() == theirs.ids.data() && mine.offsets.data() == theirs.offsets.data()
+       && mine.targets.data() == theirs.targets.data())
+    {
+        return true;
+    }
+
+    return std::equal(mine.ids.begin(), mine.ids.end(), theirs.ids.begin())
+        && std::equal(mine.offsets.begin(), mine.offsets.end(), theirs.offsets.begin())
+        && std::equal(mine.targets.begin(), mine.targets.end(), theirs.targets.begin());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::findArc(int x, int y) const noexcept
+{
+    auto begin = heads.begin() + arcOffsets[x];
+    auto end = heads.begin() + arcOffsets[x + 1];
+    auto found = std::lower_bound(begin, end, y);
+    return found != end && *found == y ? static_cast<int>(found - heads.begin()) : -1;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+void CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::runCustomization(
+    const CompactDigraph<VertexInfo, EdgeInfo>& other,
+    EdgeWeightFunc edgeWeightFunc,
+    WorkStealingPool* pool)
+{
+    if(!sameTopology(other))
+    {
+        throw DigraphException("Inconsistent CompactDigraph topology");
+    }
+    graph = other;
+
+    int n = graph.vertexCount();
+    int arcs = arcCount();
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    // Calls work(begin, end) on consecutive ranges of [0, count) that
+    // together cover it, on the pool's workers if there's enough to do.
+    auto forEachRange =
+        [pool](int count, const std::function<void(int, int)>& work)
+        {
+            int chunks = (count + customizationChunkSize - 1) / customizationChunkSize;
+            if(pool == nullptr || chunks <= 1)
+            {
+                work(0, count);
+                return;
+            }
+            pool->run(
+                chunks,
+                [&](int, int chunk)
+                {
+                    int begin = chunk * customizationChunkSize;
+                    work(begin, std::min(count, begin + customizationChunkSize));
+                });
+        };
+
+    upWeights.assign(arcs, infinity);
+    downWeights.assign(arcs, infinity);
+    upTriangles.assign(arcs, -1);
+    downTriangles.assign(arcs, -1);
+
+    // Each arc starts out with the weights of the original edges it stands
+    // for.  There's at most one in each direction, since a Digraph doesn't
+    // allow parallel edges, so no two edges write the same weight.
+    forEachRange(
+        n,
+        [&](int begin, int end)
+        {
+            for(int from = begin; from < end; from++)
+            {
+                for(int edge = graph.edgeBegin(from); edge < graph.edgeEnd(from); edge++)
+                {
+                    int r1 = rank[from];
+                    int r2 = rank[graph.edgeTarget(edge)];
+                    if(r1 < r2)
+                    {
+                        upWeights[findArc(r1, r2)] = edgeWeightFunc(graph.edgeInfoAt(edge));
+                    }
+                    else if(r2 < r1)
+                    {
+                        downWeights[findArc(r2, r1)] = edgeWeightFunc(graph.edgeInfoAt(edge));
+                    }
+                }
+            }
+        });
+
+    // Then each arc from x to y is improved by the detours through its
+    // lower triangles: x -> v -> y going up, and y -> v -> x going down.
+    // The arcs those use leave lower levels, so they're already final.
+    for(int level = 0; level + 1 < static_cast<int>(levelOffsets.size()); level++)
+    {
+        int first = levelOffsets[level];
+        forEachRange(
+            levelOffsets[level + 1] - first,
+            [&](int begin, int end)
+            {
+                for(int i = first + begin; i < first + end; i++)
+                {
+                    int x = levelRanks[i];
+                    for(int arc = arcOffsets[x]; arc < arcOffsets[x + 1]; arc++)
+                    {
+                        for(int t = triangleOffsets[arc]; t < triangleOffsets[arc + 1]; t++)
+                        {
+                            const Triangle& triangle = triangles[t];
+                            double up = downWeights[triangle.lower] + upWeights[triangle.upper];
+                            if(up < upWeights[arc])
+                            {
+                                upWeights[arc] = up;
+                                upTriangles[arc] = t;
+                            }
+                            double down = downWeights[triangle.upper] + upWeights[triangle.lower];
+                            if(down < downWeights[arc])
+                            {
+                                downWeights[arc] = down;
+                                downTriangles[arc] = t;
+                            }
+                        }
+                    }
+                }
+            });
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void CustomizableContractionHierarchy<VertexInfo, EdgeInfo>::unpack(
+    int arc, bool up, std::vector<int>& indices, DigraphPath& path) const
+{
+    // An arc that isn't a detour through a triangle stands for an original
+    // edge, from its tail to its head if it's followed up, or the other way.
+    std::vector<std::pair<int, bool>> stack{std::make_pair(arc, up)};
+    while(!stack.empty())
+    {
+        int a = stack.back().first;
+        bool isUp = stack.back().second;
+        stack.pop_back();
+
+        int t = isUp ? upTriangles[a] : downTriangles[a];
+        if(t == -1)
+        {
+            int from = order[isUp ? tails[a] : heads[a]];
+            int to = order[isUp ? heads[a] : tails[a]];
+            indices.push_back(to);
+            path.edges.push_back(graph.edgePosition(from, to));
+            path.costs.push_back(path.costs.back() + (isUp ? upWeights[a] : downWeights[a]));
+        }
+        else if(isUp)
+        {
+            stack.push_back(std::make_pair(triangles[t].upper, true));
+            stack.push_back(std::make_pair(triangles[t].lower, false));
+        }
+        else
+        {
+            stack.push_back(std::make_pair(triangles[t].lower, true));
+            stack.push_back(std::make_pair(triangles[t].upper, false));
+        }
+    }
+}
+
+
+
+#endif // CUSTOMIZABLECONTRACTIONHIERARCHY_HPP
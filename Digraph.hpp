@@ -29,8 +29,16 @@
 #include <utility>
 #include <vector>
 #include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include "ArenaAllocator.hpp"
+#include "CopyOnWrite.hpp"
+#include "StronglyConnectedComponents.hpp"
+#include "VertexIndex.hpp"
 
 
 
@@ -54,8 +62,10 @@ inline DigraphException::DigraphException(const std::string& reason)
 
 // A DigraphEdge lists a "from vertex" (the number of the vertex from which
 // the edge points), a "to vertex" (the number of the vertex to which the
-// edge points), and an EdgeInfo object.  Because different kinds of Digraphs
-// store different kinds of edge information, DigraphEdge is a struct template.
+// edge points), an EdgeInfo object, and the edge's position in the list of
+// every edge that the Digraph keeps in the order they were added.  Because
+// different kinds of Digraphs store different kinds of edge information,
+// DigraphEdge is a struct template.
 
 template <typename EdgeInfo>
 struct DigraphEdge
@@ -63,23 +73,153 @@ struct DigraphEdge
     int fromVertex;
     int toVertex;
     EdgeInfo einfo;
+    int position;
 };
 
 
 
-// A DigraphVertex includes two things: a VertexInfo object and a list of
-// its outgoing edges.  Because different kinds of Digraphs store different
-// kinds of vertex and edge information, DigraphVertex is a struct template.
+// A DigraphVertex includes three things: a VertexInfo object, a list of
+// its outgoing edges, and the vertex numbers from which its incoming edges
+// point, so that removing the vertex only has to visit its own edges.
+// Because different kinds of Digraphs store different kinds of vertex and
+// edge information, DigraphVertex is a struct template.
+//
+// The two lists get their memory through an ArenaAllocator, so that a
+// Digraph can take it from an arena of its own rather than allocating each
+// edge separately on the heap.
 
 template <typename VertexInfo, typename EdgeInfo>
 struct DigraphVertex
 {
+    typedef std::list<DigraphEdge<EdgeInfo>, ArenaAllocator<DigraphEdge<EdgeInfo>>> EdgeList;
+    typedef std::vector<int, ArenaAllocator<int>> IncomingList;
+
     VertexInfo vinfo;
-    std::list<DigraphEdge<EdgeInfo>> edges;
+    EdgeList edges;
+    IncomingList incoming;
+};
+
+
+
+
+
+// CompactDigraph (declared in CompactDigraph.hpp) builds a read-only CSR
+// snapshot of a Digraph, so it's allowed to read a Digraph's internals,
+// and DigraphBuilder (declared in DigraphBuilder.hpp) builds a Digraph all
+// at once, so it's allowed to fill them in.
+
+template <typename VertexInfo, typename EdgeInfo>
+class CompactDigraph;
+
+template <typename VertexInfo, typename EdgeInfo>
+class DigraphBuilder;
+
+template <typename VertexInfo, typename EdgeInfo>
+class Digraph;
+
+
+
+// A DigraphVertexEntry is what a Digraph's vertexRange() gives for each
+// vertex: its vertex number and its VertexInfo object, which is referred
+// to rather than copied.
+
+template <typename VertexInfo>
+struct DigraphVertexEntry
+{
+    int vertex;
+    const VertexInfo& vinfo;
+};
+
+
+
+// A DigraphRange is a view of some of a Digraph's vertices or edges, given
+// as a pair of iterators, so that it can be walked through by a range-based
+// for loop without copying anything out of the Digraph.  Like an iterator
+// into a container, it's only good until the Digraph is next changed.
+
+template <typename Iterator>
+class DigraphRange
+{
+public:
+    DigraphRange(Iterator first, Iterator last);
+
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    Iterator first;
+    Iterator last;
+};
+
+
+
+// A DigraphVertexIterator walks through the vertices of a Digraph in the
+// same order as vertices() returns them, skipping the slots of any that
+// have been removed.
+
+template <typename VertexInfo, typename EdgeInfo>
+class DigraphVertexIterator
+{
+public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef DigraphVertexEntry<VertexInfo> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef void pointer;
+    typedef DigraphVertexEntry<VertexInfo> reference;
+
+    DigraphVertexIterator(const Digraph<VertexInfo, EdgeInfo>* d, int index) noexcept;
+
+    DigraphVertexEntry<VertexInfo> operator*() const noexcept;
+    DigraphVertexIterator& operator++() noexcept;
+    DigraphVertexIterator operator++(int) noexcept;
+
+    bool operator==(const DigraphVertexIterator& other) const noexcept;
+    bool operator!=(const DigraphVertexIterator& other) const noexcept;
+
+private:
+    const Digraph<VertexInfo, EdgeInfo>* d;
+    int index;
+
+    //moves index past the slots of removed vertices
+    void skipRemoved() noexcept;
 };
 
 
 
+// A DigraphEdgeIterator walks through every edge of a Digraph, a vertex at
+// a time (in the same order as vertices() returns them), and through the
+// edges outgoing from each vertex in the order they were added.
+
+template <typename VertexInfo, typename EdgeInfo>
+class DigraphEdgeIterator
+{
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef DigraphEdge<EdgeInfo> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const DigraphEdge<EdgeInfo>* pointer;
+    typedef const DigraphEdge<EdgeInfo>& reference;
+
+    DigraphEdgeIterator(const Digraph<VertexInfo, EdgeInfo>* d, int index) noexcept;
+
+    const DigraphEdge<EdgeInfo>& operator*() const noexcept;
+    const DigraphEdge<EdgeInfo>* operator->() const noexcept;
+    DigraphEdgeIterator& operator++() noexcept;
+    DigraphEdgeIterator operator++(int) noexcept;
+
+    bool operator==(const DigraphEdgeIterator& other) const noexcept;
+    bool operator!=(const DigraphEdgeIterator& other) const noexcept;
+
+private:
+    const Digraph<VertexInfo, EdgeInfo>* d;
+    int index;
+    typename DigraphVertex<VertexInfo, EdgeInfo>::EdgeList::const_iterator edge;
+
+    //moves on to the first edge of the next vertex that has any, if edge
+    //is at the end of the list of the vertex at index
+    void skipEmpty() noexcept;
+};
+
 
 
 // Digraph is a class template that represents a directed graph implemented
@@ -94,6 +234,11 @@ struct DigraphVertex
 // Each vertex in a Digraph is identified uniquely by a "vertex number".
 // Vertex numbers are not necessarily sequential and they are not necessarily
 // zero- or one-based.
+//
+// Copies of a Digraph share their storage until one of them changes it, so
+// taking a copy (e.g., as a "what-if" scenario to close a bridge in) takes
+// constant time, and a change to the copy only pays for copying the parts
+// it touches.
 
 template <typename VertexInfo, typename EdgeInfo>
 class Digraph
@@ -105,7 +250,8 @@ public:
 
     // The copy constructor initializes a new Digraph to be a deep copy
     // of another one (i.e., any change to the copy will not affect the
-    // original).
+    // original).  It takes constant time, since the two share everything
+    // until one of them is changed.
     Digraph(const Digraph& d);
 
     // The move constructor initializes a new Digraph from an expiring one.
@@ -117,7 +263,8 @@ public:
     // The assignment operator assigns the contents of the given Digraph
     // into "this" Digraph, with "this" Digraph becoming a separate, deep
     // copy of the contents of the given one (i.e., any change made to
-    // "this" Digraph afterward will not affect the other).
+    // "this" Digraph afterward will not affect the other).  Like the copy
+    // constructor, it takes constant time.
     Digraph& operator=(const Digraph& d);
 
     // The move assignment operator assigns the contents of an expiring
@@ -140,6 +287,33 @@ public:
     // not exist, a DigraphException is thrown instead.
     std::vector<std::pair<int, int>> edges(int vertex) const;
 
+    // VertexRange, EdgeRange, and OutEdgeRange are the views returned by
+    // vertexRange(), edgeRange(), and outEdges() below.
+    typedef DigraphRange<DigraphVertexIterator<VertexInfo, EdgeInfo>> VertexRange;
+    typedef DigraphRange<DigraphEdgeIterator<VertexInfo, EdgeInfo>> EdgeRange;
+    typedef DigraphRange<typename DigraphVertex<VertexInfo, EdgeInfo>::EdgeList::const_iterator> OutEdgeRange;
+
+    // vertexRange() returns a view of every vertex in this Digraph, in the
+    // same order as vertices(), giving each one's vertex number and
+    // VertexInfo object.  Unlike vertices(), it copies nothing, so walking
+    // through it takes O(V) time and allocates no memory.
+    VertexRange vertexRange() const noexcept;
+
+    // edgeRange() returns a view of every edge in this Digraph, giving the
+    // DigraphEdge (i.e., the "from" and "to" vertex numbers and the
+    // EdgeInfo object) of each.  The edges come a vertex at a time, in the
+    // order of vertexRange(), rather than in the order of edges().  Walking
+    // through it takes O(V + E) time and allocates no memory, rather than
+    // calling edgeInfo() (which searches the "from" vertex's edges) for
+    // every edge that edges() returns.
+    EdgeRange edgeRange() const noexcept;
+
+    // outEdges() returns a view of the DigraphEdges outgoing from the given
+    // vertex number, in the same order as the overload of edges() that
+    // takes a vertex number.  If the given vertex does not exist, a
+    // DigraphException is thrown instead.
+    OutEdgeRange outEdges(int vertex) const;
+
     // vertexInfo() returns the VertexInfo object belonging to the vertex
     // with the given vertex number.  If that vertex does not exist, a
     // DigraphException is thrown instead.
@@ -164,10 +338,23 @@ public:
     // present in the graph, a DigraphException is thrown instead.
     void addEdge(int fromVertex, int toVertex, const EdgeInfo& einfo);
 
+    // setEdgeInfo() replaces the EdgeInfo object belonging to the edge with
+    // the given "from" and "to" vertex numbers (e.g., to apply a new speed
+    // limit), keeping the edge where it is in edges().  If either of those
+    // vertices does not exist *or* if the edge does not exist, a
+    // DigraphException is thrown instead.
+    void setEdgeInfo(int fromVertex, int toVertex, const EdgeInfo& einfo);
+
+    // reserve() makes room for the given numbers of vertices and edges in
+    // total, so that adding that many won't need to reallocate storage
+    // along the way.  It doesn't change the contents of the Digraph.
+    void reserve(int vertexCount, int edgeCount);
+
     // removeVertex() removes the vertex (and all of its incoming
     // and outgoing edges) with the given vertex number from the
     // Digraph.  If the vertex does not exist already, a DigraphException
-    // is thrown instead.
+    // is thrown instead.  It only visits the vertex's own edges, leaving
+    // behind the space they took up until compact() is called.
     void removeVertex(int vertex);
 
     // removeEdge() removes the edge pointing from the given "from"
@@ -177,6 +364,12 @@ public:
     // thrown instead.
     void removeEdge(int fromVertex, int toVertex);
 
+    // compact() reclaims the space left behind by every vertex and edge
+    // removed since the last call, which takes O(V + E) time; it's meant
+    // to be called once after a batch of removals (e.g., closing a set of
+    // roads).  Nothing else about the Digraph changes.
+    void compact();
+
     // vertexCount() returns the number of vertices in the graph.
     int vertexCount() const noexcept;
 
@@ -195,6 +388,13 @@ public:
     // false otherwise.
     bool isStronglyConnected() const;
 
+    // stronglyConnectedComponents() returns the strongly connected
+    // component of each vertex, in the same order as vertices() returns
+    // them.  Components are numbered from 0, in reverse topological order
+    // (an edge from one component to another always points to the one
+    // with the lower number).  It takes O(V + E) time.
+    std::vector<int> stronglyConnectedComponents() const;
+
     // findShortestPaths() takes a start vertex number and a function
     // that takes an EdgeInfo object and determines an edge weight.
     // It uses Dijkstra's Shortest Path Algorithm to determine the
@@ -209,36 +409,101 @@ public:
         int startVertex,
         std::function<double(const EdgeInfo&)> edgeWeightFunc) const;
 
+    // This overload of findShortestPaths() does the same thing, but takes
+    // the edge weight function as a template parameter instead of through
+    // a std::function, so a lambda passed to it can be inlined into the
+    // loop that relaxes each edge.
+    template <typename EdgeWeightFunc>
+    std::map<int, int> findShortestPaths(
+        int startVertex, EdgeWeightFunc edgeWeightFunc) const;
+
 
 private:
-    // Add whatever member variables you think you need here.  One
-    // possibility is a std::map where the keys are vertex numbers
-    // and the values are DigraphVertex<VertexInfo, EdgeInfo> objects.
-    std::map<int, DigraphVertex<VertexInfo, EdgeInfo>> m;
-    std::vector<int> v;
-    std::vector<std::pair<int, int>> e;
+    // The vertices are stored densely: the vertex at index i is the one
+    // whose number is v[i], and indices maps each vertex number back to
+    // that i, so finding a vertex by its number takes constant time.  The
+    // vertices themselves are kept in m in chunks of vertexChunkSize.  e
+    // lists every edge in the order they were added.
+    //
+    // Removing a vertex or an edge leaves its slot in m and v, or in e,
+    // where it stays (marked in vRemoved or eRemoved) until compact()
+    // squeezes out the slots, so removal needn't move anything else.
+    //
+    // Each part, and each chunk of m, is a CopyOnWrite, so a copy of the
+    // Digraph shares all of them; changing a vertex only copies the chunk
+    // it's in (and the list of chunks, the first time), rather than every
+    // vertex.  A CopyOnWrite hands a part over to the last Digraph sharing
+    // it only once the others are done with it, so a Digraph and its copy
+    // can be changed by different threads.
+    //
+    // The edge lists and incoming lists of the vertices that this Digraph
+    // adds take their memory from arena, which hands it out from a few
+    // large blocks and frees them all at once when the last list that uses
+    // it is gone.  (The lists in a chunk that's copied because it's shared
+    // take theirs from the heap instead.)  A copy of a Digraph starts an
+    // arena of its own when it first needs one, but the chunks it still
+    // shares, or comes to own when the other Digraph copies them away,
+    // hold lists that use the other Digraph's arena, which isn't safe for
+    // two threads to allocate from.  So writeVertexAt() first moves such a
+    // vertex's lists into this Digraph's own arena.
+    typedef std::vector<DigraphVertex<VertexInfo, EdgeInfo>> VertexChunk;
+
+    CopyOnWrite<std::vector<CopyOnWrite<VertexChunk>>> m;
+    CopyOnWrite<std::vector<int>> v;
+    CopyOnWrite<VertexIndex> indices;
+    CopyOnWrite<std::vector<std::pair<int, int>>> e;
+    CopyOnWrite<std::vector<bool>> vRemoved;
+    CopyOnWrite<std::vector<bool>> eRemoved;
+    std::shared_ptr<std::pmr::memory_resource> arena;
     int vertexC;
     int edgeC;
 
+    static constexpr int vertexChunkSize = 64;
+
     // You can also feel free to add any additional member functions
     // you'd like (public or private), so long as you don't remove or
     // change the signatures of the ones that already exist.
 
-    // if vertex doesn't exist, throw DigraphException
-    void VertexExist(int vertex) const;
+    // if vertex doesn't exist, throw DigraphException; otherwise return
+    // the index of the vertex in m and v
+    int VertexExist(int vertex) const;
 
-    //return the iterator point to the vertex in the std::map
-    typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::iterator findVertex(int vertex);
+    //return the vertex with the given vertex number, ready to be changed,
+    //throwing a DigraphException if it doesn't exist
+    DigraphVertex<VertexInfo, EdgeInfo>& findVertex(int vertex);
 
     //if the vertex exists, throw exception
     void findVertexNotExist(int vertex);
 
-    //a helper function for isStronglyConnected
-    void DFTr(int vertex, std::vector<int>& vertices) const;
+    //returns the vertex at the given index
+    const DigraphVertex<VertexInfo, EdgeInfo>& vertexAt(int index) const noexcept;
 
-    //return the index of a vertex in an vector
-    int indexOf(int vertex, std::vector<int>& vertices) const;
+    //returns the vertex at the given index, ready to be changed, having
+    //copied its chunk first if it's shared with another Digraph, and
+    //having moved its lists into this Digraph's arena if they take their
+    //memory from another Digraph's
+    DigraphVertex<VertexInfo, EdgeInfo>& writeVertexAt(int index);
 
+    //returns a vertex with the given VertexInfo and no edges, whose lists
+    //take their memory from the arena (starting one if there isn't one)
+    DigraphVertex<VertexInfo, EdgeInfo> newVertex(VertexInfo vinfo);
+
+    //stores a new vertex with the given VertexInfo at the next index
+    void appendVertex(VertexInfo vinfo);
+
+    //starts the arena, if there isn't one, with a first block big enough
+    //for the edges of the given numbers of vertices and edges
+    void reserveArena(int vertexCount, int edgeCount);
+
+    //removes the given outgoing edge (which must have come from
+    //writeVertexAt()) of the vertex at the given index, along with its
+    //slot in e and its entry in its target's incoming list
+    void unlinkEdge(int index, typename DigraphVertex<VertexInfo, EdgeInfo>::EdgeList::iterator edge);
+
+    friend class CompactDigraph<VertexInfo, EdgeInfo>;
+    friend class DigraphBuilder<VertexInfo, EdgeInfo>;
+    friend class DigraphVertexIterator<VertexInfo, EdgeInfo>;
+    friend class DigraphEdgeIterator<VertexInfo, EdgeInfo>;
 };
 
 
@@ -256,30 +521,30 @@ Digraph<VertexInfo, EdgeInfo>::Digraph()
 
 template <typename VertexInfo, typename EdgeInfo>
 Digraph<VertexInfo, EdgeInfo>::Digraph(const Digraph& d)
-    :vertexC{0}, edgeC{0}
+    :m{d.m}, v{d.v}, indices{d.indices}, e{d.e}, vRemoved{d.vRemoved}, eRemoved{d.eRemoved},
+     vertexC{d.vertexC}, edgeC{d.edgeC}
 {
-    for(int n: d.v)
-    {
-        addVertex(n, d.m.at(n).vinfo);
-    }
-    for(int n: d.v)
-    {
-        for(auto edge: d.m.at(n).edges)
-        {
-            addEdge(edge.fromVertex, edge.toVertex, edge.einfo);
-        }
-    }
+    // Copying each part only shares it with the source; the parts are
+    // copied for real as and when either Digraph changes them, which is
+    // safe even when the two Digraphs are changed by different threads
+    // (see CopyOnWrite.hpp).  The arena isn't shared, for the same reason;
+    // the lists that came from the source's arena are moved out of it as
+    // they're changed (see writeVertexAt()).
 }
 
 
 template <typename VertexInfo, typename EdgeInfo>
 Digraph<VertexInfo, EdgeInfo>::Digraph(Digraph&& d) noexcept
 {
-    vertexC = std::move(d.vertexC);
-    edgeC = std::move(d.edgeC);
+    vertexC = std::exchange(d.vertexC, 0);
+    edgeC = std::exchange(d.edgeC, 0);
     v = std::move(d.v);
     e = std::move(d.e);
     m = std::move(d.m);
+    indices = std::move(d.indices);
+    vRemoved = std::move(d.vRemoved);
+    eRemoved = std::move(d.eRemoved);
+    arena = std::move(d.arena);
 }
 
 
@@ -294,25 +559,8 @@ Digraph<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::operator=(const Di
 {
     if(this != &d)
     {
-        vertexC = 0;
-        edgeC = 0;
-        std::map<int, DigraphVertex<VertexInfo, EdgeInfo>> new_m{};
-        std::vector<int> new_v{};
-        std::vector<std::pair<int, int>> new_e{};
-        m = new_m;
-        v = new_v;
-        e = new_e;
-        for(int n: d.v)
-        {
-            addVertex(n, d.m.at(n).vinfo);
-        }
-        for(int n: d.v)
-        {
-            for(auto edge: d.m.at(n).edges)
-            {
-                addEdge(edge.fromVertex, edge.toVertex, edge.einfo);
-            }
-        }
+        Digraph copy{d};
+        *this = std::move(copy);
     }
     return *this;
 }
@@ -323,17 +571,15 @@ Digraph<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::operator=(Digraph&
 {
     if(this != &d)
     {
-        std::map<int, DigraphVertex<VertexInfo, EdgeInfo>> new_m{};
-        std::vector<int> new_v{};
-        std::vector<std::pair<int, int>> new_e{};
-        m = new_m;
-        v = new_v;
-        e = new_e;
-        vertexC = std::move(d.vertexC);
-        edgeC = std::move(d.edgeC);
+        vertexC = std::exchange(d.vertexC, 0);
+        edgeC = std::exchange(d.edgeC, 0);
         v = std::move(d.v);
         e = std::move(d.e);
         m = std::move(d.m);
+        indices = std::move(d.indices);
+        vRemoved = std::move(d.vRemoved);
+        eRemoved = std::move(d.eRemoved);
+        arena = std::move(d.arena);
     }
     return *this;
 }
@@ -342,15 +588,46 @@ Digraph<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::operator=(Digraph&
 template <typename VertexInfo, typename EdgeInfo>
 std::vector<int> Digraph<VertexInfo, EdgeInfo>::vertices() const
 {
+    const std::vector<int>& numbers = v.read();
+    if(static_cast<int>(numbers.size()) == vertexC)
+    {
+        return numbers;
+    }
 
-    return v;
+    const std::vector<bool>& removed = vRemoved.read();
+    std::vector<int> result;
+    result.reserve(vertexC);
+    for(int i = 0; i < static_cast<int>(numbers.size()); i++)
+    {
+        if(!removed[i])
+        {
+            result.push_back(numbers[i]);
+        }
+    }
+    return result;
 }
 
 
 template <typename VertexInfo, typename EdgeInfo>
 std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo>::edges() const
 {
-    return e;
+    const std::vector<std::pair<int, int>>& all = e.read();
+    if(static_cast<int>(all.size()) == edgeC)
+    {
+        return all;
+    }
+
+    const std::vector<bool>& removed = eRemoved.read();
+    std::vector<std::pair<int, int>> result;
+    result.reserve(edgeC);
+    for(int i = 0; i < static_cast<int>(all.size()); i++)
+    {
+        if(!removed[i])
+        {
+            result.push_back(all[i]);
+        }
+    }
+    return result;
 }
 
 
@@ -358,8 +635,9 @@ template <typename VertexInfo, typename EdgeInfo>
 std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo>::edges(int vertex) const
 {
     std::vector<std::pair<int, int>> result;
-    VertexExist(vertex);
-    for(auto const& it: m.at(vertex).edges)
+    int index = VertexExist(vertex);
+    result.reserve(vertexAt(index).edges.size());
+    for(auto const& it: vertexAt(index).edges)
     {
         result.push_back(std::make_pair(it.fromVertex, it.toVertex));
     }
@@ -367,20 +645,45 @@ std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo>::edges(int vertex
 }
 
 
+template <typename VertexInfo, typename EdgeInfo>
+typename Digraph<VertexInfo, EdgeInfo>::VertexRange Digraph<VertexInfo, EdgeInfo>::vertexRange() const noexcept
+{
+    return VertexRange{
+        DigraphVertexIterator<VertexInfo, EdgeInfo>{this, 0},
+        DigraphVertexIterator<VertexInfo, EdgeInfo>{this, static_cast<int>(v.read().size())}};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+typename Digraph<VertexInfo, EdgeInfo>::EdgeRange Digraph<VertexInfo, EdgeInfo>::edgeRange() const noexcept
+{
+    return EdgeRange{
+        DigraphEdgeIterator<VertexInfo, EdgeInfo>{this, 0},
+        DigraphEdgeIterator<VertexInfo, EdgeInfo>{this, static_cast<int>(v.read().size())}};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+typename Digraph<VertexInfo, EdgeInfo>::OutEdgeRange Digraph<VertexInfo, EdgeInfo>::outEdges(int vertex) const
+{
+    const typename DigraphVertex<VertexInfo, EdgeInfo>::EdgeList& edges = vertexAt(VertexExist(vertex)).edges;
+    return OutEdgeRange{edges.begin(), edges.end()};
+}
+
+
 template <typename VertexInfo, typename EdgeInfo>
 VertexInfo Digraph<VertexInfo, EdgeInfo>::vertexInfo(int vertex) const
 {
-    VertexExist(vertex);
-    return m.at(vertex).vinfo;
+    return vertexAt(VertexExist(vertex)).vinfo;
 }
 
 
 template <typename VertexInfo, typename EdgeInfo>
 EdgeInfo Digraph<VertexInfo, EdgeInfo>::edgeInfo(int fromVertex, int toVertex) const
 {
-    VertexExist(fromVertex);
+    int index = VertexExist(fromVertex);
     VertexExist(toVertex);
-    for(auto const& it: m.at(fromVertex).edges)
+    for(auto const& it: vertexAt(index).edges)
     {
         if(it.toVertex == toVertex)
         {
@@ -396,67 +699,84 @@ void Digraph<VertexInfo, EdgeInfo>::addVertex(int vertex, const VertexInfo& vinf
 {
     findVertexNotExist(vertex);
     vertexC++;
-    v.push_back(vertex);
-    m[vertex] = DigraphVertex<VertexInfo, EdgeInfo>{vinfo, {}};
+    indices.write().insert(vertex, static_cast<int>(v.read().size()));
+    v.write().push_back(vertex);
+    appendVertex(vinfo);
+    vRemoved.write().push_back(false);
 }
 
 
 template <typename VertexInfo, typename EdgeInfo>
 void Digraph<VertexInfo, EdgeInfo>::addEdge(int fromVertex, int toVertex, const EdgeInfo& einfo)
 {
-
-    typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::iterator i;
-    i = findVertex(fromVertex);
-    typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::iterator j;
-    j = findVertex(toVertex);
-    for (typename std::list<DigraphEdge<EdgeInfo>>::iterator it = i->second.edges.begin(); it != i->second.edges.end(); it++)
+    // The new edge is checked against the existing ones before anything
+    // is changed, so a failed attempt doesn't copy anything.
+    int index = VertexExist(fromVertex);
+    VertexExist(toVertex);
+    for(auto const& it: vertexAt(index).edges)
     {
-        if(it->toVertex == toVertex)
+        if(it.toVertex == toVertex)
         {
             throw DigraphException("Edge exist");
         }
     }
     edgeC++;
-    e.push_back(std::make_pair(fromVertex, toVertex));
-    i->second.edges.push_back(DigraphEdge<EdgeInfo>{fromVertex, toVertex, einfo});
+    int position = static_cast<int>(e.read().size());
+    findVertex(fromVertex).edges.push_back(DigraphEdge<EdgeInfo>{fromVertex, toVertex, einfo, position});
+    findVertex(toVertex).incoming.push_back(fromVertex);
+    e.write().push_back(std::make_pair(fromVertex, toVertex));
+    eRemoved.write().push_back(false);
 }
 
 
 template <typename VertexInfo, typename EdgeInfo>
-void Digraph<VertexInfo, EdgeInfo>::removeVertex(int vertex)
+void Digraph<VertexInfo, EdgeInfo>::setEdgeInfo(int fromVertex, int toVertex, const EdgeInfo& einfo)
 {
-    std::vector<int> v_;
-    std::vector<std::pair<int, int>> e_;
-    for(int ve: v)
+    edgeInfo(fromVertex, toVertex);
+    for(DigraphEdge<EdgeInfo>& edge: findVertex(fromVertex).edges)
     {
-        if(ve != vertex)
+        if(edge.toVertex == toVertex)
         {
-            v_.push_back(ve);
+            edge.einfo = einfo;
+            return;
         }
     }
-    auto m_ = m;
-    vertexC = 0;
-    edgeC = 0;
-    std::map<int, DigraphVertex<VertexInfo, EdgeInfo>> new_m{};
-    std::vector<int> new_v{};
-    std::vector<std::pair<int, int>> new_e{};
-    m = new_m;
-    v = new_v;
-    e = new_e;
-    for(int n: v_)
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void Digraph<VertexInfo, EdgeInfo>::removeVertex(int vertex)
+{
+    int index = VertexExist(vertex);
+    DigraphVertex<VertexInfo, EdgeInfo>& removed = writeVertexAt(index);
+
+    // The outgoing edges go first, which takes the vertex's entries out of
+    // its neighbors' incoming lists (and, for a loop from the vertex to
+    // itself, out of its own).  Then each incoming edge that's left is
+    // found in the list of the vertex it comes from.
+    while(!removed.edges.empty())
     {
-        addVertex(n, m_.at(n).vinfo);
+        unlinkEdge(index, removed.edges.begin());
     }
-    for(int n: v_)
+    for(int fromVertex: removed.incoming)
     {
-        for(auto edge: m_.at(n).edges)
+        typename DigraphVertex<VertexInfo, EdgeInfo>::EdgeList& edges = findVertex(fromVertex).edges;
+        for(auto it = edges.begin(); it != edges.end(); ++it)
         {
-            if(edge.fromVertex != vertex && edge.toVertex != vertex)
+            if(it->toVertex == vertex)
             {
-                addEdge(edge.fromVertex, edge.toVertex, edge.einfo);
+                eRemoved.write()[it->position] = true;
+                edges.erase(it);
+                edgeC--;
+                break;
             }
         }
     }
+    removed.incoming = typename DigraphVertex<VertexInfo, EdgeInfo>::IncomingList{};
+
+    indices.write().erase(vertex);
+    vRemoved.write()[index] = true;
+    vertexC--;
 }
 
 
@@ -464,19 +784,98 @@ template <typename VertexInfo, typename EdgeInfo>
 void Digraph<VertexInfo, EdgeInfo>::removeEdge(int fromVertex, int toVertex)
 {
     edgeInfo(fromVertex, toVertex);
-    edgeC--;
-    std::list<DigraphEdge<EdgeInfo>> edges_;
-    for(auto i: m.at(fromVertex).edges)
+    int index = VertexExist(fromVertex);
+    typename DigraphVertex<VertexInfo, EdgeInfo>::EdgeList& edges = writeVertexAt(index).edges;
+    for(auto it = edges.begin(); it != edges.end(); ++it)
     {
-        if(i.toVertex != toVertex)
+        if(it->toVertex == toVertex)
         {
-            edges_.push_back(DigraphEdge<EdgeInfo>{i.fromVertex, i.toVertex, i.einfo});
+            unlinkEdge(index, it);
+            return;
         }
     }
-    m.at(fromVertex).edges = edges_;
-    typename std::vector<std::pair<int, int>>::iterator it;
-    it = std::find(e.begin(), e.end(), std::make_pair(fromVertex, toVertex));
-    e.erase(it);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void Digraph<VertexInfo, EdgeInfo>::compact()
+{
+    // The edges that are left move down to fill the slots in e, and each
+    // remembers where it went so its DigraphEdge can be told below.
+    const std::vector<std::pair<int, int>>& oldEdges = e.read();
+    const std::vector<bool>& oldRemovedEdges = eRemoved.read();
+    std::vector<int> moved(oldEdges.size(), -1);
+    std::vector<std::pair<int, int>> keptEdges;
+    keptEdges.reserve(edgeC);
+    for(int i = 0; i < static_cast<int>(oldEdges.size()); i++)
+    {
+        if(!oldRemovedEdges[i])
+        {
+            moved[i] = static_cast<int>(keptEdges.size());
+            keptEdges.push_back(oldEdges[i]);
+        }
+    }
+    e = CopyOnWrite<std::vector<std::pair<int, int>>>{std::move(keptEdges)};
+    eRemoved = CopyOnWrite<std::vector<bool>>{std::vector<bool>(edgeC, false)};
+
+    // Then the vertices that are left move down to fill the slots in m and
+    // v, keeping their order, into chunks that no other Digraph shares,
+    // with their lists copied into a new arena; the old one (and the
+    // memory of every edge that was removed) is freed once no other
+    // Digraph's chunks use it.
+    arena = nullptr;
+    reserveArena(vertexC, edgeC);
+    const std::vector<int>& oldNumbers = v.read();
+    const std::vector<bool>& oldRemovedVertices = vRemoved.read();
+    std::vector<CopyOnWrite<VertexChunk>> chunks;
+    std::vector<int> numbers;
+    chunks.reserve((vertexC + vertexChunkSize - 1) / vertexChunkSize);
+    numbers.reserve(vertexC);
+    for(int i = 0; i < static_cast<int>(oldNumbers.size()); i++)
+    {
+        if(oldRemovedVertices[i])
+        {
+            continue;
+        }
+
+        int slot = static_cast<int>(numbers.size());
+        if(slot != i)
+        {
+            indices.write().insert(oldNumbers[i], slot);
+        }
+        numbers.push_back(oldNumbers[i]);
+
+        if(slot % vertexChunkSize == 0)
+        {
+            chunks.emplace_back();
+            chunks.back().write().reserve(vertexChunkSize);
+        }
+        const DigraphVertex<VertexInfo, EdgeInfo>& old = vertexAt(i);
+        VertexChunk& chunk = chunks.back().write();
+        chunk.push_back(newVertex(old.vinfo));
+        DigraphVertex<VertexInfo, EdgeInfo>& kept = chunk.back();
+        for(const DigraphEdge<EdgeInfo>& edge: old.edges)
+        {
+            kept.edges.push_back(edge);
+            kept.edges.back().position = moved[edge.position];
+        }
+        kept.incoming.assign(old.incoming.begin(), old.incoming.end());
+    }
+    m = CopyOnWrite<std::vector<CopyOnWrite<VertexChunk>>>{std::move(chunks)};
+    v = CopyOnWrite<std::vector<int>>{std::move(numbers)};
+    vRemoved = CopyOnWrite<std::vector<bool>>{std::vector<bool>(vertexC, false)};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void Digraph<VertexInfo, EdgeInfo>::reserve(int vertexCount, int edgeCount)
+{
+    m.write().reserve((vertexCount + vertexChunkSize - 1) / vertexChunkSize);
+    v.write().reserve(vertexCount);
+    vRemoved.write().reserve(vertexCount);
+    e.write().reserve(edgeCount);
+    eRemoved.write().reserve(edgeCount);
+    reserveArena(vertexCount, edgeCount);
 }
 
 
@@ -497,26 +896,58 @@ int Digraph<VertexInfo, EdgeInfo>::edgeCount() const noexcept
 template <typename VertexInfo, typename EdgeInfo>
 int Digraph<VertexInfo, EdgeInfo>::edgeCount(int vertex) const
 {
-    VertexExist(vertex);
-    return m.at(vertex).edges.size();
+    return vertexAt(VertexExist(vertex)).edges.size();
 }
 
 
 template <typename VertexInfo, typename EdgeInfo>
 bool Digraph<VertexInfo, EdgeInfo>::isStronglyConnected() const
 {
-    bool result = true;
-    for(int vertex: v)
+    std::vector<int> components = stronglyConnectedComponents();
+    return std::all_of(
+        components.begin(), components.end(),
+        [](int component)
+        {
+            return component == 0;
+        });
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<int> Digraph<VertexInfo, EdgeInfo>::stronglyConnectedComponents() const
+{
+    // The adjacency lists hold vertex numbers, so they're turned into CSR
+    // arrays of indices first, numbering only the slots of vertices that
+    // haven't been removed.
+    const std::vector<bool>& removed = vRemoved.read();
+    int slots = static_cast<int>(removed.size());
+    std::vector<int> dense(slots, -1);
+    int n = 0;
+    for(int i = 0; i < slots; i++)
     {
-        std::vector<int> vertices = v;
-        DFTr(vertex, vertices);
-        if (vertices.size() != 0)
+        if(!removed[i])
         {
-            result = false;
-            break;
+            dense[i] = n++;
         }
     }
-    return result;
+
+    std::vector<int> offsets(vertexC + 1, 0);
+    std::vector<int> targets;
+    targets.reserve(edgeC);
+    for(int i = 0; i < slots; i++)
+    {
+        if(dense[i] == -1)
+        {
+            continue;
+        }
+        for(const auto& edge: vertexAt(i).edges)
+        {
+            targets.push_back(dense[indices.read().find(edge.toVertex)]);
+        }
+        offsets[dense[i] + 1] = static_cast<int>(targets.size());
+    }
+
+    return findStronglyConnectedComponents(vertexC, offsets, targets);
 }
 
 
@@ -525,16 +956,26 @@ std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findShortestPaths(
     int startVertex,
     std::function<double(const EdgeInfo&)> edgeWeightFunc) const
 {
-    std::vector<bool> Kv (v.size(), false);
-    std::map<int, int> Pv;
-    for (auto vertex: v)
+    return findShortestPaths<const std::function<double(const EdgeInfo&)>&>(
+        startVertex, edgeWeightFunc);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeWeightFunc>
+std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findShortestPaths(
+    int startVertex, EdgeWeightFunc edgeWeightFunc) const
+{
+    int startIndex = VertexExist(startVertex);
+    const std::vector<int>& numbers = v.read();
+
+    std::vector<bool> Kv (numbers.size(), false);
+    std::vector<int> Pv (numbers.size());
+    for(int i = 0; i < static_cast<int>(numbers.size()); i++)
     {
-        Pv[vertex] = vertex;
+        Pv[i] = i;
     }
-    std::vector<double> Dv (v.size(), std::numeric_limits<double>::max());
-    std::vector<int> vertices = v;
-
-    int startIndex = indexOf(startVertex, vertices);
+    std::vector<double> Dv (numbers.size(), std::numeric_limits<double>::max());
     Dv[startIndex] = 0;
 
     std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>, std::greater<std::pair<double, int>>> pq;
@@ -544,55 +985,53 @@ std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findShortestPaths(
         int vertex = pq.top().second;
         pq.pop();
 
-        int index = indexOf(vertex, vertices);
-        
+        int index = indices.read().find(vertex);
+
         if(Kv[index] == false)
         {
             Kv[index] = true;
-            for(auto edge: m.at(vertex).edges)
+            for(const auto& edge: vertexAt(index).edges)
             {
-                int w = edge.toVertex;
-                int indexW = indexOf(w, vertices);
-                if(Dv[indexW] > Dv[index] + edgeWeightFunc(edgeInfo(vertex, w)))
+                int indexW = indices.read().find(edge.toVertex);
+                double d = Dv[index] + edgeWeightFunc(edge.einfo);
+                if(Dv[indexW] > d)
                 {
-                    Dv[indexW] = Dv[index] + edgeWeightFunc(edgeInfo(vertex, w));
-                    Pv[w] = vertex;
-                    pq.push(std::make_pair(Dv[indexW], w));
+                    Dv[indexW] = d;
+                    Pv[indexW] = index;
+                    pq.push(std::make_pair(d, edge.toVertex));
                 }
             }
         }
     }
-    return Pv;
-}
 
-template <typename VertexInfo, typename EdgeInfo>
-void Digraph<VertexInfo, EdgeInfo>::VertexExist(int vertex) const
-{
-    int r = -1;
-    for(int i = 0; i < v.size(); i++)
+    const std::vector<bool>& removed = vRemoved.read();
+    std::map<int, int> result;
+    for(int i = 0; i < static_cast<int>(numbers.size()); i++)
     {
-        if(v[i] == vertex)
+        if(!removed[i])
         {
-            r = i;
+            result[numbers[i]] = numbers[Pv[i]];
         }
     }
-    if(r == -1)
+    return result;
+}
+
+template <typename VertexInfo, typename EdgeInfo>
+int Digraph<VertexInfo, EdgeInfo>::VertexExist(int vertex) const
+{
+    int index = indices.read().find(vertex);
+    if(index == -1)
     {
         throw DigraphException("Vertex " + std::to_string(vertex) + "not exist");
     }
+    return index;
 }
 
 
 template <typename VertexInfo, typename EdgeInfo>
-typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::iterator Digraph<VertexInfo, EdgeInfo>::findVertex(int vertex)
+DigraphVertex<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::findVertex(int vertex)
 {
-    typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::iterator i;
-    i = m.find(vertex);
-    if (i == m.end())
-    {
-        throw DigraphException("Vertex " + std::to_string(vertex) + "not exist");
-    }
-    return i;
+    return writeVertexAt(VertexExist(vertex));
 }
 
 
@@ -600,59 +1039,264 @@ typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::iterator Digraph<Ve
 template <typename VertexInfo, typename EdgeInfo>
 void Digraph<VertexInfo, EdgeInfo>::findVertexNotExist(int vertex)
 {
-    typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::const_iterator i;
-    i = m.find(vertex);
-    if (i != m.end())
+    if (indices.read().find(vertex) != -1)
     {
         throw DigraphException("Vertex " + std::to_string(vertex) + " exist");
     }
 }
 
+
+template <typename VertexInfo, typename EdgeInfo>
+const DigraphVertex<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::vertexAt(int index) const noexcept
+{
+    return m.read()[index / vertexChunkSize].read()[index % vertexChunkSize];
+}
+
+
 template <typename VertexInfo, typename EdgeInfo>
-void Digraph<VertexInfo, EdgeInfo>::DFTr(int vertex, std::vector<int>& vertices) const
+DigraphVertex<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::writeVertexAt(int index)
 {
-    int index = -1;
-    for(int i = 0; i < vertices.size(); i++)
+    DigraphVertex<VertexInfo, EdgeInfo>& vertex = m.write()[index / vertexChunkSize].write()[index % vertexChunkSize];
+
+    // Lists that take their memory from the heap, or from this Digraph's
+    // arena, can be changed as they are.  The others came from a Digraph
+    // this one was copied from (or that was copied from it), which may go
+    // on allocating from their arena on another thread.
+    std::pmr::memory_resource* edgesArena = vertex.edges.get_allocator().arena().get();
+    std::pmr::memory_resource* incomingArena = vertex.incoming.get_allocator().arena().get();
+    if((edgesArena != nullptr && edgesArena != arena.get())
+        || (incomingArena != nullptr && incomingArena != arena.get()))
     {
-        if(vertices.at(i) == vertex)
+        if(arena == nullptr)
         {
-            index = i;
-            break;
+            arena = std::make_shared<std::pmr::monotonic_buffer_resource>();
         }
+        vertex.edges = typename DigraphVertex<VertexInfo, EdgeInfo>::EdgeList{
+            vertex.edges.begin(), vertex.edges.end(), ArenaAllocator<DigraphEdge<EdgeInfo>>{arena}};
+        vertex.incoming = typename DigraphVertex<VertexInfo, EdgeInfo>::IncomingList{
+            vertex.incoming.begin(), vertex.incoming.end(), ArenaAllocator<int>{arena}};
     }
-    vertices.erase(vertices.begin() + index);
-    for(auto edge: m.at(vertex).edges)
+    return vertex;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphVertex<VertexInfo, EdgeInfo> Digraph<VertexInfo, EdgeInfo>::newVertex(VertexInfo vinfo)
+{
+    if(arena == nullptr)
     {
-        int index = -1;
-        for(int i = 0; i < vertices.size(); i++)
-        {
-            if(vertices.at(i) == edge.toVertex)
-            {
-                index = i;
-                break;
-            }
-        }
-        if(index != -1)
-        {
-            DFTr(edge.toVertex, vertices);
-        }
+        arena = std::make_shared<std::pmr::monotonic_buffer_resource>();
     }
+    return DigraphVertex<VertexInfo, EdgeInfo>{
+        std::move(vinfo),
+        typename DigraphVertex<VertexInfo, EdgeInfo>::EdgeList{ArenaAllocator<DigraphEdge<EdgeInfo>>{arena}},
+        typename DigraphVertex<VertexInfo, EdgeInfo>::IncomingList{ArenaAllocator<int>{arena}}};
 }
 
+
 template <typename VertexInfo, typename EdgeInfo>
-int Digraph<VertexInfo, EdgeInfo>::indexOf(int vertex, std::vector<int>& vertices) const
+void Digraph<VertexInfo, EdgeInfo>::appendVertex(VertexInfo vinfo)
 {
-    int index = -1;
-    for(int i = 0; i < vertices.size(); i++)
+    std::vector<CopyOnWrite<VertexChunk>>& chunks = m.write();
+    if(chunks.empty() || static_cast<int>(chunks.back().read().size()) == vertexChunkSize)
     {
-        if(vertices.at(i) == vertex)
-        {
-            index = i;
-            break;
-        }
+        chunks.emplace_back();
+        chunks.back().write().reserve(vertexChunkSize);
     }
-    return index;
+    chunks.back().write().push_back(newVertex(std::move(vinfo)));
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void Digraph<VertexInfo, EdgeInfo>::reserveArena(int vertexCount, int edgeCount)
+{
+    // Each edge takes a node in its "from" vertex's edge list (which holds
+    // the DigraphEdge and two links) and an int in its "to" vertex's
+    // incoming list, which is given room to grow.
+    if(arena == nullptr)
+    {
+        std::size_t edgeBytes = sizeof(DigraphEdge<EdgeInfo>) + 2 * sizeof(void*) + 2 * sizeof(int);
+        std::size_t bytes = static_cast<std::size_t>(edgeCount) * edgeBytes
+            + static_cast<std::size_t>(vertexCount) * sizeof(int);
+        arena = std::make_shared<std::pmr::monotonic_buffer_resource>(std::max<std::size_t>(bytes, 1));
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void Digraph<VertexInfo, EdgeInfo>::unlinkEdge(int index, typename DigraphVertex<VertexInfo, EdgeInfo>::EdgeList::iterator edge)
+{
+    typename DigraphVertex<VertexInfo, EdgeInfo>::IncomingList& incoming = findVertex(edge->toVertex).incoming;
+    auto from = std::find(incoming.begin(), incoming.end(), v.read()[index]);
+    *from = incoming.back();
+    incoming.pop_back();
+
+    eRemoved.write()[edge->position] = true;
+    writeVertexAt(index).edges.erase(edge);
+    edgeC--;
+}
+
+
+template <typename Iterator>
+DigraphRange<Iterator>::DigraphRange(Iterator first, Iterator last)
+    : first{first}, last{last}
+{
+}
+
+
+template <typename Iterator>
+Iterator DigraphRange<Iterator>::begin() const
+{
+    return first;
+}
+
+
+template <typename Iterator>
+Iterator DigraphRange<Iterator>::end() const
+{
+    return last;
+}
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphVertexIterator<VertexInfo, EdgeInfo>::DigraphVertexIterator(
+    const Digraph<VertexInfo, EdgeInfo>* d, int index) noexcept
+    : d{d}, index{index}
+{
+    skipRemoved();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphVertexEntry<VertexInfo> DigraphVertexIterator<VertexInfo, EdgeInfo>::operator*() const noexcept
+{
+    return DigraphVertexEntry<VertexInfo>{d->v.read()[index], d->vertexAt(index).vinfo};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphVertexIterator<VertexInfo, EdgeInfo>& DigraphVertexIterator<VertexInfo, EdgeInfo>::operator++() noexcept
+{
+    index++;
+    skipRemoved();
+    return *this;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphVertexIterator<VertexInfo, EdgeInfo> DigraphVertexIterator<VertexInfo, EdgeInfo>::operator++(int) noexcept
+{
+    DigraphVertexIterator old{*this};
+    ++*this;
+    return old;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+bool DigraphVertexIterator<VertexInfo, EdgeInfo>::operator==(const DigraphVertexIterator& other) const noexcept
+{
+    return d == other.d && index == other.index;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+bool DigraphVertexIterator<VertexInfo, EdgeInfo>::operator!=(const DigraphVertexIterator& other) const noexcept
+{
+    return !(*this == other);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DigraphVertexIterator<VertexInfo, EdgeInfo>::skipRemoved() noexcept
+{
+    const std::vector<bool>& removed = d->vRemoved.read();
+    int slots = static_cast<int>(removed.size());
+    while(index < slots && removed[index])
+    {
+        index++;
+    }
+}
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphEdgeIterator<VertexInfo, EdgeInfo>::DigraphEdgeIterator(
+    const Digraph<VertexInfo, EdgeInfo>* d, int index) noexcept
+    : d{d}, index{index}
+{
+    if(index < static_cast<int>(d->v.read().size()))
+    {
+        edge = d->vertexAt(index).edges.begin();
+    }
+    skipEmpty();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const DigraphEdge<EdgeInfo>& DigraphEdgeIterator<VertexInfo, EdgeInfo>::operator*() const noexcept
+{
+    return *edge;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const DigraphEdge<EdgeInfo>* DigraphEdgeIterator<VertexInfo, EdgeInfo>::operator->() const noexcept
+{
+    return &*edge;
 }
 
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphEdgeIterator<VertexInfo, EdgeInfo>& DigraphEdgeIterator<VertexInfo, EdgeInfo>::operator++() noexcept
+{
+    ++edge;
+    skipEmpty();
+    return *this;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphEdgeIterator<VertexInfo, EdgeInfo> DigraphEdgeIterator<VertexInfo, EdgeInfo>::operator++(int) noexcept
+{
+    DigraphEdgeIterator old{*this};
+    ++*this;
+    return old;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+bool DigraphEdgeIterator<VertexInfo, EdgeInfo>::operator==(const DigraphEdgeIterator& other) const noexcept
+{
+    return d == other.d && index == other.index && edge == other.edge;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+bool DigraphEdgeIterator<VertexInfo, EdgeInfo>::operator!=(const DigraphEdgeIterator& other) const noexcept
+{
+    return !(*this == other);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DigraphEdgeIterator<VertexInfo, EdgeInfo>::skipEmpty() noexcept
+{
+    // The slots of removed vertices always have empty lists, so they're
+    // skipped along with vertices that have no outgoing edges.  Once the
+    // last slot is passed, edge is left value-initialized, just like the
+    // one in the iterator returned by edgeRange().end().
+    int slots = static_cast<int>(d->v.read().size());
+    while(index < slots && edge == d->vertexAt(index).edges.end())
+    {
+        index++;
+        edge = index < slots
+            ? d->vertexAt(index).edges.begin()
+            : typename DigraphVertex<VertexInfo, EdgeInfo>::EdgeList::const_iterator{};
+    }
+}
+
+
+
 #endif // DIGRAPH_HPP
 
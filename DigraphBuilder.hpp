@@ -0,0 +1,206 @@
+// DigraphBuilder.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A DigraphBuilder collects the vertices and edges of a Digraph and then
+// builds the Digraph all at once.  Adding them to a Digraph one at a time
+// checks each new edge against every edge already leaving the same vertex,
+// which makes loading a vertex with many outgoing edges take time that's
+// quadratic in their number.  A DigraphBuilder instead accepts vertices and
+// edges without checking anything, then checks them all in build(), which
+// takes time linear in the number of vertices and edges.
+//
+// The Digraph that build() returns is the same one that adding each vertex
+// with addVertex() and then each edge with addEdge(), in the order they
+// were given to the DigraphBuilder, would have produced; any problem that
+// those calls would have reported with a DigraphException is reported by
+// build() with the same DigraphException.
+
+#ifndef DIGRAPHBUILDER_HPP
+#define DIGRAPHBUILDER_HPP
+
+#include <utility>
+#include <vector>
+#include "Digraph.hpp"
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+class DigraphBuilder
+{
+public:
+    // reserve() makes room for the given numbers of vertices and edges.
+    void reserve(int vertexCount, int edgeCount);
+
+    // addVertex() adds a vertex with the given vertex number and
+    // VertexInfo object to the Digraph being built.
+    void addVertex(int vertex, const VertexInfo& vinfo);
+
+    // addEdge() adds an edge pointing from the given "from" vertex number
+    // to the given "to" vertex number, with the given EdgeInfo object, to
+    // the Digraph being built.  The vertices can be added before or after
+    // the edge.
+    void addEdge(int fromVertex, int toVertex, const EdgeInfo& einfo);
+
+    // build() returns the Digraph made of the vertices and edges added so
+    // far, leaving the DigraphBuilder empty.  If two vertices have the
+    // same vertex number, an edge refers to a vertex that wasn't added, or
+    // two edges have the same "from" and "to" vertex numbers, a
+    // DigraphException is thrown instead and the DigraphBuilder is left as
+    // it was.
+    Digraph<VertexInfo, EdgeInfo> build();
+
+private:
+    std::vector<int> vertices;
+    std::vector<VertexInfo> vinfos;
+    std::vector<DigraphEdge<EdgeInfo>> edges;
+};
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DigraphBuilder<VertexInfo, EdgeInfo>::reserve(int vertexCount, int edgeCount)
+{
+    vertices.reserve(vertexCount);
+    vinfos.reserve(vertexCount);
+    edges.reserve(edgeCount);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DigraphBuilder<VertexInfo, EdgeInfo>::addVertex(int vertex, const VertexInfo& vinfo)
+{
+    vertices.push_back(vertex);
+    vinfos.push_back(vinfo);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void DigraphBuilder<VertexInfo, EdgeInfo>::addEdge(int fromVertex, int toVertex, const EdgeInfo& einfo)
+{
+    edges.push_back(DigraphEdge<EdgeInfo>{fromVertex, toVertex, einfo, -1});
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+Digraph<VertexInfo, EdgeInfo> DigraphBuilder<VertexInfo, EdgeInfo>::build()
+{
+    int n = static_cast<int>(vertices.size());
+    int edgeCount = static_cast<int>(edges.size());
+
+    Digraph<VertexInfo, EdgeInfo> d;
+    VertexIndex& indices = d.indices.write();
+    for(int i = 0; i < n; i++)
+    {
+        if(indices.find(vertices[i]) != -1)
+        {
+            throw DigraphException("Vertex " + std::to_string(vertices[i]) + " exist");
+        }
+        indices.insert(vertices[i], i);
+    }
+
+    // Find the edges' vertices, stopping at the first edge that refers to
+    // a vertex that doesn't exist; only the edges before it are checked
+    // for duplicates, since addEdge() would never have got past it.
+    std::vector<int> fromIndices(edgeCount);
+    std::vector<int> toIndices(edgeCount);
+    std::vector<int> starts(n + 1, 0);
+    int checked = edgeCount;
+    for(int i = 0; i < edgeCount; i++)
+    {
+        fromIndices[i] = indices.find(edges[i].fromVertex);
+        toIndices[i] = indices.find(edges[i].toVertex);
+        if(fromIndices[i] == -1 || toIndices[i] == -1)
+        {
+            checked = i;
+            break;
+        }
+        starts[fromIndices[i] + 1]++;
+    }
+    for(int i = 0; i < n; i++)
+    {
+        starts[i + 1] += starts[i];
+    }
+
+    // Sort those edges by the index of their "from" vertex with a counting
+    // sort, which keeps the edges leaving each vertex in the order they
+    // were added.
+    std::vector<int> order(checked);
+    std::vector<int> next(starts.begin(), starts.end() - 1);
+    for(int i = 0; i < checked; i++)
+    {
+        order[next[fromIndices[i]]++] = i;
+    }
+
+    // Then one pass finds any duplicate among them: lastFrom[t] records
+    // the last "from" index seen with an edge into the vertex with index
+    // t, and the edges are visited grouped by their "from" index.  Every
+    // duplicate comes before the first edge with a missing vertex, so
+    // addEdge() would have reported it first.
+    std::vector<int> lastFrom(n, -1);
+    for(int position = 0; position < checked; position++)
+    {
+        int i = order[position];
+        if(lastFrom[toIndices[i]] == fromIndices[i])
+        {
+            throw DigraphException("Edge exist");
+        }
+        lastFrom[toIndices[i]] = fromIndices[i];
+    }
+    if(checked < edgeCount)
+    {
+        d.VertexExist(edges[checked].fromVertex);
+        d.VertexExist(edges[checked].toVertex);
+    }
+
+    d.v = CopyOnWrite<std::vector<int>>{std::move(vertices)};
+    d.reserveArena(n, edgeCount);
+    for(int i = 0; i < n; i++)
+    {
+        d.appendVertex(std::move(vinfos[i]));
+    }
+
+    // Each vertex's incoming list is given exactly the room it needs, so
+    // none of them grows (leaving its old storage behind in the Digraph's
+    // arena) along the way.
+    std::vector<int> inDegrees(n, 0);
+    for(int i = 0; i < edgeCount; i++)
+    {
+        inDegrees[toIndices[i]]++;
+    }
+    for(int i = 0; i < n; i++)
+    {
+        d.writeVertexAt(i).incoming.reserve(inDegrees[i]);
+    }
+
+    std::vector<std::pair<int, int>> edgePairs;
+    edgePairs.reserve(edgeCount);
+    for(int i = 0; i < edgeCount; i++)
+    {
+        edgePairs.push_back(std::make_pair(edges[i].fromVertex, edges[i].toVertex));
+        d.writeVertexAt(toIndices[i]).incoming.push_back(edges[i].fromVertex);
+        edges[i].position = i;
+    }
+    for(int position = 0; position < edgeCount; position++)
+    {
+        int i = order[position];
+        d.writeVertexAt(fromIndices[i]).edges.push_back(std::move(edges[i]));
+    }
+    d.e = CopyOnWrite<std::vector<std::pair<int, int>>>{std::move(edgePairs)};
+    d.vRemoved = CopyOnWrite<std::vector<bool>>{std::vector<bool>(n, false)};
+    d.eRemoved = CopyOnWrite<std::vector<bool>>{std::vector<bool>(edgeCount, false)};
+
+    d.vertexC = n;
+    d.edgeC = edgeCount;
+
+    vertices = std::vector<int>{};
+    vinfos = std::vector<VertexInfo>{};
+    edges = std::vector<DigraphEdge<EdgeInfo>>{};
+    return d;
+}
+
+
+
+#endif // DIGRAPHBUILDER_HPP
+
@@ -0,0 +1,249 @@
+// DijkstraWorkspace.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A DijkstraWorkspace holds the scratch space that a shortest path search
+// needs: a distance, a predecessor and a "settled" flag for every vertex,
+// plus the storage behind the search's priority queue.  A caller answering
+// many queries (e.g., one worker evaluating a batch of trips) can keep one
+// DijkstraWorkspace and pass it to every query, so that the space is only
+// allocated once instead of once per query.
+//
+// Starting a new search doesn't clear the entries of every vertex, which
+// would make even a search that only looks at a handful of vertices cost
+// time proportional to the size of the graph.  Instead, each entry carries
+// a stamp recording the search that last wrote it, and an entry stamped by
+// an earlier search reads as if it had never been written.  Starting a new
+// search just moves on to a new stamp.
+//
+// A DijkstraWorkspace can't be shared by two searches running at the same
+// time; each thread needs its own, and a bidirectional search needs one
+// for each direction.
+//
+// The workspace also owns the search's priority queue, whose type is the
+// template parameter of BasicDijkstraWorkspace: a BinaryHeapQueue, an
+// IndexedHeapQueue or a RadixHeapQueue.  A DijkstraWorkspace is one with a
+// BinaryHeapQueue, which is what searches use unless they're handed a
+// workspace with another kind of queue.
+//
+// Its second template parameter says what statistics it keeps about each
+// search (see SearchStats.hpp): by default none, at no cost.  A
+// CountingDijkstraWorkspace is a DijkstraWorkspace that keeps SearchStats.
+
+#ifndef DIJKSTRAWORKSPACE_HPP
+#define DIJKSTRAWORKSPACE_HPP
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "BinaryHeapQueue.hpp"
+#include "SearchStats.hpp"
+
+
+
+template <typename PriorityQueue, typename Stats = NoSearchStats>
+class BasicDijkstraWorkspace
+{
+public:
+    // The default constructor initializes a workspace with no space in it
+    // yet; the first reset() allocates it.
+    BasicDijkstraWorkspace();
+
+    // reset() prepares the workspace for a new search over a graph with
+    // the given number of vertices: every vertex is unreached, nothing is
+    // settled and the queue is empty.  Unless the graph has grown since
+    // the last search, this takes constant time.  The stats are zeroed.
+    void reset(int vertexCount);
+
+    // reached() returns true if the vertex at the given index has been
+    // given a distance by the current search, false otherwise.
+    bool reached(int index) const noexcept;
+
+    // distance() returns the distance the current search has recorded for
+    // the vertex at the given index, which is infinite if it's unreached.
+    double distance(int index) const noexcept;
+
+    // predecessor() returns the index of the predecessor recorded for the
+    // vertex at the given index, or -1 if it has none.
+    int predecessor(int index) const noexcept;
+
+    // settled() returns true if the vertex at the given index has been
+    // settled by the current search, false otherwise.
+    bool settled(int index) const noexcept;
+
+    // estimate() returns the heuristic estimate recorded for the vertex at
+    // the given index (see setEstimate()), or NaN if there isn't one.
+    double estimate(int index) const noexcept;
+
+    // reach() records a distance and a predecessor for the vertex at the
+    // given index, as the current search relaxes an edge into it.
+    void reach(int index, double distance, int predecessor) noexcept;
+
+    // settle() marks the vertex at the given index as settled; a vertex
+    // that hasn't been reached yet is also given an infinite distance and
+    // no predecessor.
+    void settle(int index) noexcept;
+
+    // setEstimate() records a heuristic estimate (e.g., of the remaining
+    // cost from the vertex to a goal, for A*) for the vertex at the given
+    // index, so that it needn't be computed again during this search.
+    void setEstimate(int index, double estimate) noexcept;
+
+    // touched() returns the number of vertices the current search has
+    // reached, settled or given an estimate.
+    int touched() const noexcept;
+
+    // queue is the search's priority queue of vertex indices
+    PriorityQueue queue;
+
+    // stats are the statistics kept about the current search
+    Stats stats;
+
+private:
+    struct Entry
+    {
+        double distance;
+        double estimate;
+        int predecessor;
+        std::uint32_t stamp;
+        bool settled;
+    };
+
+    std::vector<Entry> entries;
+    std::uint32_t stamp;
+    int touchedCount;
+
+    //returns the entry at the given index, wiping it first if it was
+    //written by an earlier search
+    Entry& current(int index) noexcept;
+};
+
+
+typedef BasicDijkstraWorkspace<BinaryHeapQueue> DijkstraWorkspace;
+typedef BasicDijkstraWorkspace<BinaryHeapQueue, SearchStats> CountingDijkstraWorkspace;
+
+
+
+template <typename PriorityQueue, typename Stats>
+BasicDijkstraWorkspace<PriorityQueue, Stats>::BasicDijkstraWorkspace()
+    : stamp{0}, touchedCount{0}
+{
+}
+
+
+template <typename PriorityQueue, typename Stats>
+void BasicDijkstraWorkspace<PriorityQueue, Stats>::reset(int vertexCount)
+{
+    // Stamp 0 never belongs to a search, so new entries start out stale;
+    // when the stamps run out, every entry is made stale again instead.
+    if(stamp == std::numeric_limits<std::uint32_t>::max())
+    {
+        for(Entry& entry: entries)
+        {
+            entry.stamp = 0;
+        }
+        stamp = 0;
+    }
+    stamp++;
+
+    if(static_cast<int>(entries.size()) < vertexCount)
+    {
+        entries.resize(vertexCount, Entry{0, 0, -1, 0, false});
+    }
+
+    touchedCount = 0;
+    queue.reserve(vertexCount);
+    queue.clear();
+    stats = Stats{};
+}
+
+
+template <typename PriorityQueue, typename Stats>
+bool BasicDijkstraWorkspace<PriorityQueue, Stats>::reached(int index) const noexcept
+{
+    return entries[index].stamp == stamp
+        && entries[index].distance != std::numeric_limits<double>::infinity();
+}
+
+
+template <typename PriorityQueue, typename Stats>
+double BasicDijkstraWorkspace<PriorityQueue, Stats>::distance(int index) const noexcept
+{
+    return entries[index].stamp == stamp
+        ? entries[index].distance : std::numeric_limits<double>::infinity();
+}
+
+
+template <typename PriorityQueue, typename Stats>
+int BasicDijkstraWorkspace<PriorityQueue, Stats>::predecessor(int index) const noexcept
+{
+    return entries[index].stamp == stamp ? entries[index].predecessor : -1;
+}
+
+
+template <typename PriorityQueue, typename Stats>
+bool BasicDijkstraWorkspace<PriorityQueue, Stats>::settled(int index) const noexcept
+{
+    return entries[index].stamp == stamp && entries[index].settled;
+}
+
+
+template <typename PriorityQueue, typename Stats>
+double BasicDijkstraWorkspace<PriorityQueue, Stats>::estimate(int index) const noexcept
+{
+    return entries[index].stamp == stamp
+        ? entries[index].estimate : std::numeric_limits<double>::quiet_NaN();
+}
+
+
+template <typename PriorityQueue, typename Stats>
+void BasicDijkstraWorkspace<PriorityQueue, Stats>::reach(int index, double distance, int predecessor) noexcept
+{
+    Entry& entry = current(index);
+    entry.distance = distance;
+    entry.predecessor = predecessor;
+}
+
+
+template <typename PriorityQueue, typename Stats>
+void BasicDijkstraWorkspace<PriorityQueue, Stats>::settle(int index) noexcept
+{
+    current(index).settled = true;
+}
+
+
+template <typename PriorityQueue, typename Stats>
+void BasicDijkstraWorkspace<PriorityQueue, Stats>::setEstimate(int index, double estimate) noexcept
+{
+    current(index).estimate = estimate;
+}
+
+
+template <typename PriorityQueue, typename Stats>
+int BasicDijkstraWorkspace<PriorityQueue, Stats>::touched() const noexcept
+{
+    return touchedCount;
+}
+
+
+template <typename PriorityQueue, typename Stats>
+typename BasicDijkstraWorkspace<PriorityQueue, Stats>::Entry& BasicDijkstraWorkspace<PriorityQueue, Stats>::current(int index) noexcept
+{
+    Entry& entry = entries[index];
+    if(entry.stamp != stamp)
+    {
+        entry = Entry{
+            std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::quiet_NaN(),
+            -1, stamp, false};
+        touchedCount++;
+    }
+    return entry;
+}
+
+
+
+#endif // DIJKSTRAWORKSPACE_HPP
+
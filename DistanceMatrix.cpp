@@ -0,0 +1,64 @@
+// DistanceMatrix.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <cstddef>
+#include <limits>
+#include "DistanceMatrix.hpp"
+
+
+DistanceMatrix::DistanceMatrix()
+    : rowCount_{0}, columnCount_{0}
+{
+}
+
+
+DistanceMatrix::DistanceMatrix(int rowCount, int columnCount)
+    : rowCount_{rowCount}, columnCount_{columnCount},
+      entries_(static_cast<std::size_t>(rowCount) * columnCount, std::numeric_limits<double>::infinity())
+{
+}
+
+
+int DistanceMatrix::rowCount() const noexcept
+{
+    return rowCount_;
+}
+
+
+int DistanceMatrix::columnCount() const noexcept
+{
+    return columnCount_;
+}
+
+
+double DistanceMatrix::at(int row, int column) const noexcept
+{
+    return entries_[static_cast<std::size_t>(row) * columnCount_ + column];
+}
+
+
+double& DistanceMatrix::at(int row, int column) noexcept
+{
+    return entries_[static_cast<std::size_t>(row) * columnCount_ + column];
+}
+
+
+const double* DistanceMatrix::row(int row) const noexcept
+{
+    return entries_.data() + static_cast<std::size_t>(row) * columnCount_;
+}
+
+
+double* DistanceMatrix::row(int row) noexcept
+{
+    return entries_.data() + static_cast<std::size_t>(row) * columnCount_;
+}
+
+
+const double* DistanceMatrix::data() const noexcept
+{
+    return entries_.data();
+}
+
@@ -0,0 +1,59 @@
+// DistanceMatrix.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A DistanceMatrix is the outcome of a many-to-many shortest path query:
+// the cost of a shortest path from each of a list of sources (its rows) to
+// each of a list of targets (its columns), e.g., from every depot of a
+// fleet to every customer.  An entry is infinite if its target can't be
+// reached from its source.
+//
+// The entries are kept in one contiguous block, a row at a time, so that a
+// whole row (or the whole matrix) can be handed to code that expects a
+// plain array of doubles.
+
+#ifndef DISTANCEMATRIX_HPP
+#define DISTANCEMATRIX_HPP
+
+#include <vector>
+
+
+
+class DistanceMatrix
+{
+public:
+    // The default constructor initializes a matrix with no rows and no
+    // columns.
+    DistanceMatrix();
+
+    // This constructor initializes a matrix with the given numbers of rows
+    // and columns, every entry of which is infinite.
+    DistanceMatrix(int rowCount, int columnCount);
+
+    // rowCount() and columnCount() return the numbers of rows and columns.
+    int rowCount() const noexcept;
+    int columnCount() const noexcept;
+
+    // at() returns the entry in the given row and column.
+    double at(int row, int column) const noexcept;
+    double& at(int row, int column) noexcept;
+
+    // row() returns the first of the columnCount() contiguous entries of
+    // the given row.
+    const double* row(int row) const noexcept;
+    double* row(int row) noexcept;
+
+    // data() returns the first of all rowCount() * columnCount() entries,
+    // one row after another.
+    const double* data() const noexcept;
+
+private:
+    int rowCount_;
+    int columnCount_;
+    std::vector<double> entries_;
+};
+
+
+
+#endif // DISTANCEMATRIX_HPP
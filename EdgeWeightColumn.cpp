@@ -0,0 +1,31 @@
+// EdgeWeightColumn.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <utility>
+#include "EdgeWeightColumn.hpp"
+
+
+EdgeWeightColumn::EdgeWeightColumn()
+{
+}
+
+
+EdgeWeightColumn::EdgeWeightColumn(std::vector<double> weights)
+    : weights_{std::move(weights)}
+{
+}
+
+
+std::size_t EdgeWeightColumn::size() const noexcept
+{
+    return weights_.size();
+}
+
+
+const double* EdgeWeightColumn::data() const noexcept
+{
+    return weights_.data();
+}
+
@@ -0,0 +1,60 @@
+// EdgeWeightColumn.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// An EdgeWeightColumn holds the weight of every edge of a CompactDigraph
+// under some edge weight function, in edge position order, as one
+// contiguous array of doubles (see CompactDigraph::weightColumn()).  Any
+// search of that CompactDigraph can be given an EdgeWeightColumn in place
+// of the edge weight function, and then looks each weight up instead of
+// working it out again from the EdgeInfo every time an edge is relaxed
+// (e.g., dividing a RoadSegment's miles by its speed); that also halves
+// the memory a search reads for each edge, compared to a RoadSegment.
+//
+// The weights are doubles, so the searches find exactly the same costs
+// (and choose the same paths) as they do with the edge weight function.
+
+#ifndef EDGEWEIGHTCOLUMN_HPP
+#define EDGEWEIGHTCOLUMN_HPP
+
+#include <cstddef>
+#include <vector>
+#include "CompactArray.hpp"
+
+
+
+class EdgeWeightColumn
+{
+public:
+    // The default constructor initializes an EdgeWeightColumn with no
+    // weights.
+    EdgeWeightColumn();
+
+    // This constructor initializes an EdgeWeightColumn with the given
+    // weights, in edge position order.
+    explicit EdgeWeightColumn(std::vector<double> weights);
+
+    // size() returns the number of weights.
+    std::size_t size() const noexcept;
+
+    // operator[] returns the weight of the edge at the given position.
+    double operator[](int edge) const noexcept;
+
+    // data() returns the first of the weights.
+    const double* data() const noexcept;
+
+private:
+    CompactArray<double> weights_;
+};
+
+
+
+inline double EdgeWeightColumn::operator[](int edge) const noexcept
+{
+    return weights_[edge];
+}
+
+
+
+#endif // EDGEWEIGHTCOLUMN_HPP
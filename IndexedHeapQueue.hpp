@@ -0,0 +1,203 @@
+// IndexedHeapQueue.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// An IndexedHeapQueue is a priority queue for shortest path searches that
+// holds at most one entry per vertex.  It's a d-ary min-heap (a 4-ary one
+// by default, which is shallower than a binary heap and keeps each node's
+// children together in memory) that also records where each vertex's entry
+// is, so that push() on a vertex that's already in the queue decreases its
+// key in place instead of adding a duplicate.  The queue never grows past
+// the number of vertices, and there are no stale entries to pop.
+//
+// It has the same member functions as a BinaryHeapQueue, and breaks ties
+// the same way, so a search settles vertices in the same order with either.
+
+#ifndef INDEXEDHEAPQUEUE_HPP
+#define INDEXEDHEAPQUEUE_HPP
+
+#include <utility>
+#include <vector>
+
+
+
+template <int Arity = 4>
+class IndexedHeapQueue
+{
+    static_assert(Arity >= 2, "an IndexedHeapQueue needs an arity of at least 2");
+
+public:
+    // reserve() prepares the queue to hold the vertices of a graph with
+    // the given number of vertices.
+    void reserve(int vertexCount);
+
+    // clear() removes every entry from the queue, in time proportional to
+    // the number of entries in it.
+    void clear() noexcept;
+
+    // empty() returns true if the queue has no entries, false otherwise.
+    bool empty() const noexcept;
+
+    // top() returns the (key, vertex index) pair with the smallest key.
+    // The queue must not be empty.
+    const std::pair<double, int>& top() const noexcept;
+
+    // push() adds an entry for the vertex at the given index with the
+    // given key or, if the vertex is already in the queue, lowers its key
+    // to the given one (a larger key leaves it alone).
+    void push(int index, double key);
+
+    // pop() removes the entry that top() returns.  The queue must not be
+    // empty.
+    void pop();
+
+private:
+    std::vector<std::pair<double, int>> heap;
+
+    // positions[i] is where the entry for the vertex at index i is in
+    // heap, or -1 if it isn't in the queue
+    std::vector<int> positions;
+
+    //moves the entry at the given position up or down the heap until
+    //it's in order, keeping positions up to date
+    void siftUp(int position) noexcept;
+    void siftDown(int position) noexcept;
+};
+
+
+
+template <int Arity>
+void IndexedHeapQueue<Arity>::reserve(int vertexCount)
+{
+    if(static_cast<int>(positions.size()) < vertexCount)
+    {
+        positions.resize(vertexCount, -1);
+    }
+}
+
+
+template <int Arity>
+void IndexedHeapQueue<Arity>::clear() noexcept
+{
+    for(const std::pair<double, int>& entry: heap)
+    {
+        positions[entry.second] = -1;
+    }
+    heap.clear();
+}
+
+
+template <int Arity>
+bool IndexedHeapQueue<Arity>::empty() const noexcept
+{
+    return heap.empty();
+}
+
+
+template <int Arity>
+const std::pair<double, int>& IndexedHeapQueue<Arity>::top() const noexcept
+{
+    return heap.front();
+}
+
+
+template <int Arity>
+void IndexedHeapQueue<Arity>::push(int index, double key)
+{
+    int position = positions[index];
+    if(position == -1)
+    {
+        position = static_cast<int>(heap.size());
+        heap.push_back(std::make_pair(key, index));
+        positions[index] = position;
+    }
+    else if(key < heap[position].first)
+    {
+        heap[position].first = key;
+    }
+    else
+    {
+        return;
+    }
+    siftUp(position);
+}
+
+
+template <int Arity>
+void IndexedHeapQueue<Arity>::pop()
+{
+    positions[heap.front().second] = -1;
+    if(heap.size() > 1)
+    {
+        heap.front() = heap.back();
+        positions[heap.front().second] = 0;
+        heap.pop_back();
+        siftDown(0);
+    }
+    else
+    {
+        heap.pop_back();
+    }
+}
+
+
+template <int Arity>
+void IndexedHeapQueue<Arity>::siftUp(int position) noexcept
+{
+    std::pair<double, int> entry = heap[position];
+    while(position > 0)
+    {
+        int parent = (position - 1) / Arity;
+        if(!(entry < heap[parent]))
+        {
+            break;
+        }
+        heap[position] = heap[parent];
+        positions[heap[position].second] = position;
+        position = parent;
+    }
+    heap[position] = entry;
+    positions[entry.second] = position;
+}
+
+
+template <int Arity>
+void IndexedHeapQueue<Arity>::siftDown(int position) noexcept
+{
+    int size = static_cast<int>(heap.size());
+    std::pair<double, int> entry = heap[position];
+    while(true)
+    {
+        int first = position * Arity + 1;
+        if(first >= size)
+        {
+            break;
+        }
+
+        int last = first + Arity < size ? first + Arity : size;
+        int smallest = first;
+        for(int child = first + 1; child < last; child++)
+        {
+            if(heap[child] < heap[smallest])
+            {
+                smallest = child;
+            }
+        }
+
+        if(!(heap[smallest] < entry))
+        {
+            break;
+        }
+        heap[position] = heap[smallest];
+        positions[heap[position].second] = position;
+        position = smallest;
+    }
+    heap[position] = entry;
+    positions[entry.second] = position;
+}
+
+
+
+#endif // INDEXEDHEAPQUEUE_HPP
+
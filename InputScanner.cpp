@@ -0,0 +1,163 @@
+// InputScanner.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <charconv>
+#include <cstring>
+#include "InputScanner.hpp"
+
+
+namespace
+{
+    // The input stream is read this many bytes at a time.
+    const std::size_t chunkSize = 1 << 20;
+
+
+    // The same characters that std::isspace() accepts in the "C" locale,
+    // which InputReader uses to trim its lines.
+    bool isSpace(char c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+    }
+
+
+    template <typename T>
+    T takeNumber(std::string_view& line, const char* description)
+    {
+        // std::from_chars() doesn't accept a leading '+', but the stream
+        // extraction that the other readers use does.
+        const char* first = line.data();
+        const char* last = line.data() + line.size();
+        if (first != last && *first == '+' && first + 1 != last && *(first + 1) != '-')
+        {
+            ++first;
+        }
+
+        T value;
+        std::from_chars_result result = std::from_chars(first, last, value);
+        if (result.ec != std::errc{})
+        {
+            throw InputScannerException(
+                "Expected " + std::string{description} + " in \"" + std::string{line} + "\"");
+        }
+
+        line.remove_prefix(result.ptr - line.data());
+        return value;
+    }
+}
+
+
+InputScanner::InputScanner(std::istream& in)
+{
+    std::streambuf* buffer = in.rdbuf();
+    std::size_t size = 0;
+
+    while (true)
+    {
+        contents.resize(size + chunkSize);
+        std::streamsize got = buffer->sgetn(contents.data() + size, chunkSize);
+        size += static_cast<std::size_t>(got);
+
+        if (static_cast<std::size_t>(got) < chunkSize)
+        {
+            break;
+        }
+    }
+
+    contents.resize(size);
+    next = contents.data();
+    end = contents.data() + size;
+}
+
+
+InputScanner::InputScanner(const std::string& path)
+    : file{std::make_shared<const MappedFile>(path)}
+{
+    next = file->data();
+    end = file->data() + file->size();
+}
+
+
+std::string_view InputScanner::readLine()
+{
+    while (next != end)
+    {
+        const char* newline = static_cast<const char*>(std::memchr(next, '\n', end - next));
+        const char* lineEnd = newline != nullptr ? newline : end;
+
+        std::string_view line{next, static_cast<std::size_t>(lineEnd - next)};
+        next = newline != nullptr ? newline + 1 : end;
+
+        while (!line.empty() && isSpace(line.back()))
+        {
+            line.remove_suffix(1);
+        }
+
+        if (line.length() > 0 && line[0] != '#')
+        {
+            return line;
+        }
+    }
+
+    throw InputScannerException("Unexpected end of input");
+}
+
+
+int InputScanner::readIntLine()
+{
+    std::string_view line = readLine();
+    return takeInt(line);
+}
+
+
+int InputScanner::capLineCount(int count) const noexcept
+{
+    if (count <= 0)
+    {
+        return 0;
+    }
+
+    std::size_t mostLines = (static_cast<std::size_t>(end - next) + 1) / 2;
+    return static_cast<std::size_t>(count) < mostLines ? count : static_cast<int>(mostLines);
+}
+
+
+int InputScanner::takeInt(std::string_view& line)
+{
+    skipSpaces(line);
+    return takeNumber<int>(line, "an integer");
+}
+
+
+double InputScanner::takeDouble(std::string_view& line)
+{
+    skipSpaces(line);
+    return takeNumber<double>(line, "a number");
+}
+
+
+std::string_view InputScanner::takeWord(std::string_view& line)
+{
+    skipSpaces(line);
+
+    std::size_t length = 0;
+    while (length < line.size() && !isSpace(line[length]))
+    {
+        ++length;
+    }
+
+    std::string_view word = line.substr(0, length);
+    line.remove_prefix(length);
+    return word;
+}
+
+
+void InputScanner::skipSpaces(std::string_view& line) noexcept
+{
+    while (!line.empty() && isSpace(line.front()))
+    {
+        line.remove_prefix(1);
+    }
+}
+
@@ -0,0 +1,99 @@
+// InputScanner.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// An InputScanner is the bulk counterpart of an InputReader, for input
+// large enough that reading it a line at a time is the bottleneck.  The
+// whole input is brought into memory at once -- by mapping a file into
+// memory, or by reading an input stream in large chunks -- and lines are
+// then handed out as std::string_views into it, without copying them.  The
+// same lines are skipped as an InputReader skips: blank lines, lines
+// containing only spaces, and lines that begin with a '#' character.
+//
+// The take...() functions parse the fields of a line, using
+// std::from_chars() rather than a std::istringstream.
+//
+// Running out of input, or a field that isn't what it's expected to be,
+// causes an InputScannerException to be thrown.
+
+#ifndef INPUTSCANNER_HPP
+#define INPUTSCANNER_HPP
+
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "MappedFile.hpp"
+
+
+
+class InputScannerException : public std::runtime_error
+{
+public:
+    InputScannerException(const std::string& reason);
+};
+
+
+inline InputScannerException::InputScannerException(const std::string& reason)
+    : std::runtime_error{reason}
+{
+}
+
+
+
+class InputScanner
+{
+public:
+    // This constructor reads everything that's left in the given input
+    // stream (e.g., std::cin) into memory.
+    explicit InputScanner(std::istream& in);
+
+    // This constructor maps the file with the given path into memory.  If
+    // it can't be mapped, a MappedFileException is thrown instead.
+    explicit InputScanner(const std::string& path);
+
+    // readLine() returns the next meaningful line of input, with any
+    // spaces at the end removed.  The std::string_view refers to memory
+    // owned by this InputScanner, so it's only valid as long as it is.
+    std::string_view readLine();
+
+    // readIntLine() reads the next meaningful line of input, which is
+    // expected to begin with an integer value (e.g., "7"), and returns
+    // that value.
+    int readIntLine();
+
+    // capLineCount() returns the given count of lines about to be read,
+    // lowered to the most meaningful lines the rest of the input could
+    // hold (each takes at least one character and a newline), or to 0 if
+    // it's negative.  It's how much room can safely be reserved for what
+    // a count read from the input says is coming.
+    int capLineCount(int count) const noexcept;
+
+    // takeInt(), takeDouble() and takeWord() parse the next field of a
+    // line: an integer, a floating-point number, or a run of characters
+    // other than spaces.  Spaces before the field are skipped, and the
+    // field is removed from the front of the line.
+    static int takeInt(std::string_view& line);
+    static double takeDouble(std::string_view& line);
+    static std::string_view takeWord(std::string_view& line);
+
+private:
+    // the input, if it was mapped from a file or read from a stream
+    std::shared_ptr<const MappedFile> file;
+    std::vector<char> contents;
+
+    // the part of the input that hasn't been read yet
+    const char* next;
+    const char* end;
+
+    //removes any spaces from the front of the line
+    static void skipSpaces(std::string_view& line) noexcept;
+};
+
+
+
+#endif // INPUTSCANNER_HPP
+
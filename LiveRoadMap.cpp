@@ -0,0 +1,87 @@
+// LiveRoadMap.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <atomic>
+#include "LiveRoadMap.hpp"
+
+
+namespace
+{
+    CompactArray<RoadSegment> viewOf(const std::shared_ptr<std::vector<RoadSegment>>& segments)
+    {
+        return CompactArray<RoadSegment>{segments, segments->data(), segments->size()};
+    }
+}
+
+
+LiveRoadMap::LiveRoadMap(const CompactRoadMap& roadMap)
+    : front_{0}
+{
+    CompactDigraphArrays<std::string, RoadSegment> arrays = roadMap.arrays();
+    buffers_[0] = std::make_shared<Segments>(arrays.einfos.begin(), arrays.einfos.end());
+    buffers_[1] = std::make_shared<Segments>(*buffers_[0]);
+
+    current_ = std::make_shared<const CompactRoadMap>(roadMap.withEdgeInfos(viewOf(buffers_[0])));
+}
+
+
+std::shared_ptr<const CompactRoadMap> LiveRoadMap::snapshot() const
+{
+    return std::atomic_load(&current_);
+}
+
+
+void LiveRoadMap::updateSpeeds(const std::vector<SpeedUpdate>& updates)
+{
+    std::lock_guard<std::mutex> lock{updates_};
+    const CompactRoadMap& roadMap = *current_;
+
+    // Find every segment before changing any of them, so that a batch with
+    // a bad update leaves the map as it was.
+    std::vector<std::pair<int, double>> changes;
+    changes.reserve(updates.size());
+
+    for (const SpeedUpdate& update : updates)
+    {
+        int edge = roadMap.edgePosition(
+            roadMap.indexOf(update.fromVertex), roadMap.indexOf(update.toVertex));
+
+        if (edge == -1)
+        {
+            throw DigraphException("No such edge exist");
+        }
+
+        changes.push_back(std::make_pair(edge, update.milesPerHour));
+    }
+
+    // The back buffer can only be written if no snapshot still refers to
+    // it; since it isn't the current snapshot's, nobody can start to.
+    std::shared_ptr<Segments>& back = buffers_[1 - front_];
+
+    if (back.use_count() > 1)
+    {
+        back = std::make_shared<Segments>(*buffers_[front_]);
+    }
+    else
+    {
+        for (const std::pair<int, double>& change : pending_)
+        {
+            (*back)[change.first].milesPerHour = change.second;
+        }
+    }
+
+    for (const std::pair<int, double>& change : changes)
+    {
+        (*back)[change.first].milesPerHour = change.second;
+    }
+
+    std::atomic_store(
+        &current_,
+        std::make_shared<const CompactRoadMap>(roadMap.withEdgeInfos(viewOf(back))));
+
+    front_ = 1 - front_;
+    pending_ = std::move(changes);
+}
+
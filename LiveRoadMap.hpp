@@ -0,0 +1,81 @@
+// LiveRoadMap.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A LiveRoadMap keeps a CompactRoadMap up to date with a feed of live
+// traffic speeds.  Each batch of SpeedUpdates is applied in place, to the
+// road segments' weights only, without rebuilding the graph: the vertices,
+// edges and indices are shared by every version of the map, and only the
+// array of RoadSegments changes.
+//
+// Queries run against a snapshot(), which never changes once it's been
+// taken, so a query that's already running when a batch arrives keeps
+// seeing the speeds it started with.  The RoadSegments are double-buffered:
+// a batch is written into the buffer that isn't being read, which is then
+// published as the new snapshot.  If that buffer is still in use by an old
+// snapshot, a fresh copy is made instead of overwriting it.
+//
+// Anything derived from the speeds when a snapshot was taken goes stale
+// when the speeds change.  A RoadMapHierarchies has to be rebuilt from a
+// newer snapshot; a RoadMapCustomizableHierarchy only has to be customized
+// again with one.
+
+#ifndef LIVEROADMAP_HPP
+#define LIVEROADMAP_HPP
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "RoadMap.hpp"
+
+
+
+struct SpeedUpdate
+{
+    int fromVertex;
+    int toVertex;
+    double milesPerHour;
+};
+
+
+
+class LiveRoadMap
+{
+public:
+    // Initializes a LiveRoadMap whose first snapshot has the same vertices,
+    // edges and speeds as the given map.
+    explicit LiveRoadMap(const CompactRoadMap& roadMap);
+
+    // snapshot() returns the current version of the map.  It's safe to
+    // call while another thread is calling updateSpeeds().
+    std::shared_ptr<const CompactRoadMap> snapshot() const;
+
+    // updateSpeeds() sets the speed of each given road segment, then
+    // publishes the result as the new snapshot.  If a segment appears more
+    // than once, the last of its updates wins.  If any update names a road
+    // segment that does not exist, a DigraphException is thrown and none
+    // of the updates are applied.
+    void updateSpeeds(const std::vector<SpeedUpdate>& updates);
+
+private:
+    typedef std::vector<RoadSegment> Segments;
+
+    // updates_ serializes the calls to updateSpeeds(); current_ is read and
+    // written with std::atomic_load() and std::atomic_store(), so snapshot()
+    // doesn't need to take the mutex
+    std::mutex updates_;
+    std::shared_ptr<const CompactRoadMap> current_;
+
+    // buffers_[front_] holds the segments of the current snapshot; pending_
+    // holds the changes (edge position and speed) made to the front buffer
+    // that haven't been made to the other one yet
+    std::shared_ptr<Segments> buffers_[2];
+    int front_;
+    std::vector<std::pair<int, double>> pending_;
+};
+
+
+
+#endif // LIVEROADMAP_HPP
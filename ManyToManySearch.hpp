@@ -0,0 +1,160 @@
+// ManyToManySearch.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This header file declares a function template that fills in a
+// DistanceMatrix by the bucket-based many-to-many search over a hierarchy
+// of upward arcs.  Both ContractionHierarchy and
+// CustomizableContractionHierarchy use it.
+//
+// In a hierarchy, every shortest path climbs from its source to its
+// highest-ranked vertex and descends from there to its target, so its cost
+// is the lowest sum, over the vertices v that an upward search from the
+// source and a backward upward search from the target both settle, of the
+// distances to v in the two.  Rather than pairing each source with each
+// target in a query of its own, one backward search is run from each
+// target, leaving an entry naming the target and its distance in the
+// "bucket" of every vertex it settles; then one forward search is run
+// from each source, and each vertex it settles is combined with every
+// entry in that vertex's bucket.  That's |S| + |T| searches, each of which
+// only settles a tiny part of the graph, instead of |S| * |T| queries.
+//
+// The searches of each phase don't depend on one another, so they're
+// spread over the workers of a WorkStealingPool.
+
+#ifndef MANYTOMANYSEARCH_HPP
+#define MANYTOMANYSEARCH_HPP
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "DijkstraWorkspace.hpp"
+#include "DistanceMatrix.hpp"
+#include "WorkStealingPool.hpp"
+
+
+
+// findManyToManyDistances() takes the number of vertices n in the
+// hierarchy and the indices of the sources and targets, and returns the
+// matrix of shortest distances from each source to each target.  The arcs
+// are given by two functions, each called as arcs(index, relax): forward
+// calls relax(w, weight) for every upward arc from index to w, and
+// backward does the same for every upward arc whose reverse leads from w
+// down to index.
+
+template <typename ForwardArcsFunc, typename BackwardArcsFunc>
+DistanceMatrix findManyToManyDistances(
+    int n, const std::vector<int>& sources, const std::vector<int>& targets,
+    ForwardArcsFunc forward, BackwardArcsFunc backward, WorkStealingPool& pool)
+{
+    struct BucketEntry
+    {
+        int column;
+        double distance;
+    };
+
+    int rows = static_cast<int>(sources.size());
+    int columns = static_cast<int>(targets.size());
+    DistanceMatrix matrix{rows, columns};
+    std::vector<DijkstraWorkspace> workspaces(pool.workerCount());
+
+    // search() settles everything reachable along the given arcs from the
+    // vertex at index start, calling visit(index, distance) for each.
+    auto search =
+        [n](DijkstraWorkspace& workspace, int start, auto arcs, auto visit)
+        {
+            workspace.reset(n);
+            BinaryHeapQueue& pq = workspace.queue;
+            workspace.reach(start, 0, -1);
+            pq.push(start, 0);
+            while(!pq.empty())
+            {
+                int index = pq.top().second;
+                pq.pop();
+                if(workspace.settled(index))
+                {
+                    continue;
+                }
+
+                workspace.settle(index);
+                double d = workspace.distance(index);
+                visit(index, d);
+                arcs(
+                    index,
+                    [&workspace, &pq, index, d](int w, double weight)
+                    {
+                        if(workspace.distance(w) > d + weight)
+                        {
+                            workspace.reach(w, d + weight, index);
+                            pq.push(w, d + weight);
+                        }
+                    });
+            }
+        };
+
+    // The backward searches each record what they settle separately, and
+    // the records are then sorted into buckets by vertex index, so that
+    // the buckets come out the same no matter which worker ran which.
+    std::vector<std::vector<std::pair<int, double>>> settled(columns);
+    pool.run(
+        columns,
+        [&](int worker, int column)
+        {
+            search(
+                workspaces[worker], targets[column], backward,
+                [&settled, column](int index, double distance)
+                {
+                    settled[column].push_back(std::make_pair(index, distance));
+                });
+        });
+
+    std::vector<int> bucketOffsets(n + 1, 0);
+    for(const std::vector<std::pair<int, double>>& reached: settled)
+    {
+        for(const std::pair<int, double>& entry: reached)
+        {
+            bucketOffsets[entry.first + 1]++;
+        }
+    }
+    for(int i = 0; i < n; i++)
+    {
+        bucketOffsets[i + 1] += bucketOffsets[i];
+    }
+
+    std::vector<BucketEntry> buckets(bucketOffsets[n]);
+    std::vector<int> next(bucketOffsets.begin(), bucketOffsets.end() - 1);
+    for(int column = 0; column < columns; column++)
+    {
+        for(const std::pair<int, double>& entry: settled[column])
+        {
+            buckets[next[entry.first]++] = BucketEntry{column, entry.second};
+        }
+        settled[column] = std::vector<std::pair<int, double>>{};
+    }
+
+    // Each forward search fills in one row, so no two of them ever write
+    // the same entry.
+    pool.run(
+        rows,
+        [&](int worker, int r)
+        {
+            double* row = matrix.row(r);
+            search(
+                workspaces[worker], sources[r], forward,
+                [&buckets, &bucketOffsets, row](int index, double distance)
+                {
+                    for(int i = bucketOffsets[index]; i < bucketOffsets[index + 1]; i++)
+                    {
+                        const BucketEntry& entry = buckets[i];
+                        row[entry.column] = std::min(row[entry.column], distance + entry.distance);
+                    }
+                });
+        });
+
+    return matrix;
+}
+
+
+
+#endif // MANYTOMANYSEARCH_HPP
@@ -0,0 +1,99 @@
+// MappedFile.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include "MappedFile.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPEDFILE_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+
+#if defined(MAPPEDFILE_USE_MMAP)
+
+MappedFile::MappedFile(const std::string& path)
+    : bytes{nullptr}, length{0}
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw MappedFileException("Cannot open " + path);
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) == -1)
+    {
+        ::close(fd);
+        throw MappedFileException("Cannot read the size of " + path);
+    }
+
+    length = static_cast<std::size_t>(status.st_size);
+
+    // An empty file can't be mapped, but there's nothing to map anyway.
+    if (length != 0)
+    {
+        void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED)
+        {
+            ::close(fd);
+            throw MappedFileException("Cannot map " + path + " into memory");
+        }
+        bytes = static_cast<const char*>(mapped);
+    }
+
+    // The mapping stays valid after the file is closed.
+    ::close(fd);
+}
+
+
+MappedFile::~MappedFile() noexcept
+{
+    if (bytes != nullptr)
+    {
+        ::munmap(const_cast<char*>(bytes), length);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+    : bytes{nullptr}, length{0}
+{
+    std::ifstream in{path, std::ios::binary};
+    if (!in)
+    {
+        throw MappedFileException("Cannot open " + path);
+    }
+
+    contents.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+    bytes = contents.data();
+    length = contents.size();
+}
+
+
+MappedFile::~MappedFile() noexcept
+{
+}
+
+#endif
+
+
+const char* MappedFile::data() const noexcept
+{
+    return bytes;
+}
+
+
+std::size_t MappedFile::size() const noexcept
+{
+    return length;
+}
+
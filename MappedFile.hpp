@@ -0,0 +1,70 @@
+// MappedFile.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A MappedFile makes the whole contents of a file available, read-only, at
+// some address in memory.  On POSIX systems, the file is mapped into memory
+// with mmap(), so nothing is actually read until the memory is touched, and
+// then only the pages that are touched; elsewhere, the contents are read
+// into memory all at once.  Either way, the contents stay available until
+// the MappedFile is destroyed.
+//
+// Problems opening or mapping the file are reported by throwing a
+// MappedFileException.
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+
+class MappedFileException : public std::runtime_error
+{
+public:
+    MappedFileException(const std::string& reason);
+};
+
+
+inline MappedFileException::MappedFileException(const std::string& reason)
+    : std::runtime_error{reason}
+{
+}
+
+
+
+class MappedFile
+{
+public:
+    // This constructor maps the file with the given path into memory.
+    explicit MappedFile(const std::string& path);
+
+    // A MappedFile can't be copied, since it owns the mapping.
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // The destructor unmaps the file.
+    ~MappedFile() noexcept;
+
+    // data() returns the address of the first byte of the file's contents.
+    const char* data() const noexcept;
+
+    // size() returns the number of bytes in the file.
+    std::size_t size() const noexcept;
+
+private:
+    const char* bytes;
+    std::size_t length;
+
+    // holds the contents when they've been read instead of mapped
+    std::vector<char> contents;
+};
+
+
+
+#endif // MAPPEDFILE_HPP
+
@@ -0,0 +1,212 @@
+// RadixHeapQueue.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A RadixHeapQueue is a priority queue for shortest path searches that
+// takes advantage of the keys only ever moving forward: once a key has
+// been popped, every key pushed afterward is at least as large (called a
+// "monotone" queue).  Dijkstra's algorithm with non-negative edge weights
+// uses its queue that way, as does A* with a consistent heuristic.
+//
+// Entries are kept in buckets according to the highest bit in which their
+// key differs from the last key popped, so pushing an entry is just adding
+// it to a bucket; popping only looks into a bucket when the lowest one has
+// run out, then spreads that bucket over the buckets below it.  Each entry
+// moves down at most once for each bit of its key, rather than being
+// compared its way through a heap.
+//
+// Radix heaps are usually described over integer keys (e.g., travel times
+// rounded to centiseconds).  The keys here are non-negative doubles, which
+// compare the same way as their 64-bit representations do when those are
+// read as unsigned integers, so the buckets are chosen from those instead;
+// the distances stay exact, and no rounding is needed.
+//
+// Like a BinaryHeapQueue, whose member functions it shares, it adds a new
+// entry for a vertex that's pushed again, leaving the search to skip the
+// stale one.  Entries with the same key are popped in an unspecified order.
+// Pushing a key smaller than one already popped, or a negative key, leaves
+// the queue in an unspecified order.
+
+#ifndef RADIXHEAPQUEUE_HPP
+#define RADIXHEAPQUEUE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+
+
+class RadixHeapQueue
+{
+public:
+    // The default constructor initializes an empty queue.
+    RadixHeapQueue();
+
+    // reserve() prepares the queue to hold the vertices of a graph with
+    // the given number of vertices.
+    void reserve(int vertexCount);
+
+    // clear() removes every entry from the queue, and forgets the last
+    // key popped, so that the next search can start over from 0.
+    void clear() noexcept;
+
+    // empty() returns true if the queue has no entries, false otherwise.
+    bool empty() const noexcept;
+
+    // top() returns a (key, vertex index) pair with the smallest key.  It
+    // isn't a const member function, because finding that pair may move
+    // entries between buckets.  The queue must not be empty.
+    const std::pair<double, int>& top();
+
+    // push() adds an entry for the vertex at the given index with the
+    // given key.
+    void push(int index, double key);
+
+    // pop() removes the entry that top() returns.  The queue must not be
+    // empty.
+    void pop();
+
+private:
+    // buckets[0] holds the entries whose key is the last key popped, and
+    // buckets[b] those whose key first differs from it in bit b - 1
+    static constexpr int bucketCount = 65;
+    std::vector<std::pair<double, int>> buckets[bucketCount];
+    std::uint64_t last;
+    int count;
+
+    //returns the bits of a non-negative key, as an unsigned integer
+    static std::uint64_t bitsOf(double key) noexcept;
+
+    //returns the bucket in which the given key bits belong
+    static int bucketOf(std::uint64_t bits, std::uint64_t last) noexcept;
+
+    //refills buckets[0], if it's empty, from the lowest bucket that isn't
+    void refill();
+};
+
+
+
+inline RadixHeapQueue::RadixHeapQueue()
+    : last{0}, count{0}
+{
+}
+
+
+inline void RadixHeapQueue::reserve(int)
+{
+}
+
+
+inline void RadixHeapQueue::clear() noexcept
+{
+    for(std::vector<std::pair<double, int>>& bucket: buckets)
+    {
+        bucket.clear();
+    }
+    last = 0;
+    count = 0;
+}
+
+
+inline bool RadixHeapQueue::empty() const noexcept
+{
+    return count == 0;
+}
+
+
+inline const std::pair<double, int>& RadixHeapQueue::top()
+{
+    refill();
+    return buckets[0].back();
+}
+
+
+inline void RadixHeapQueue::push(int index, double key)
+{
+    buckets[bucketOf(bitsOf(key), last)].push_back(std::make_pair(key, index));
+    count++;
+}
+
+
+inline void RadixHeapQueue::pop()
+{
+    refill();
+    buckets[0].pop_back();
+    count--;
+}
+
+
+inline std::uint64_t RadixHeapQueue::bitsOf(double key) noexcept
+{
+    // Adding 0 turns -0 into +0, which is the same key with other bits.
+    key += 0.0;
+    std::uint64_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return bits;
+}
+
+
+inline int RadixHeapQueue::bucketOf(std::uint64_t bits, std::uint64_t last) noexcept
+{
+    // The bucket is one more than the position of the highest set bit of
+    // the difference.  GCC and Clang can find it in a single instruction;
+    // elsewhere, it's found by halving the range it could be in.
+    std::uint64_t difference = bits ^ last;
+#if defined(__GNUC__)
+    return difference == 0 ? 0 : 64 - __builtin_clzll(difference);
+#else
+    int bucket = 0;
+    for(int shift = 32; shift > 0; shift /= 2)
+    {
+        if((difference >> shift) != 0)
+        {
+            difference >>= shift;
+            bucket += shift;
+        }
+    }
+    return bucket + static_cast<int>(difference);
+#endif
+}
+
+
+inline void RadixHeapQueue::refill()
+{
+    if(!buckets[0].empty())
+    {
+        return;
+    }
+
+    int b = 1;
+    while(buckets[b].empty())
+    {
+        b++;
+    }
+
+    // Every entry in bucket b shares the bits above bit b - 1 with the
+    // smallest of them, and differs from it below that, so once that
+    // smallest key is the last one popped, they all go in lower buckets.
+    std::vector<std::pair<double, int>>& bucket = buckets[b];
+    std::uint64_t smallest = bitsOf(bucket.front().first);
+    for(const std::pair<double, int>& entry: bucket)
+    {
+        std::uint64_t bits = bitsOf(entry.first);
+        if(bits < smallest)
+        {
+            smallest = bits;
+        }
+    }
+
+    last = smallest;
+    for(const std::pair<double, int>& entry: bucket)
+    {
+        buckets[bucketOf(bitsOf(entry.first), last)].push_back(entry);
+    }
+    bucket.clear();
+}
+
+
+
+#endif // RADIXHEAPQUEUE_HPP
+
@@ -0,0 +1,39 @@
+// ReachabilityIndex.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include "ReachabilityIndex.hpp"
+
+
+Reachability ReachabilityIndex::reachability(int fromIndex, int toIndex) const noexcept
+{
+    int from = components_[fromIndex];
+    int to = components_[toIndex];
+
+    if (from == to)
+    {
+        return Reachability::Reachable;
+    }
+
+    if (from < to || levels_[from] <= levels_[to]
+        || weakComponents_[fromIndex] != weakComponents_[toIndex])
+    {
+        return Reachability::Unreachable;
+    }
+
+    return Reachability::Unknown;
+}
+
+
+int ReachabilityIndex::componentOf(int index) const noexcept
+{
+    return components_[index];
+}
+
+
+int ReachabilityIndex::componentCount() const noexcept
+{
+    return static_cast<int>(levels_.size());
+}
+
@@ -0,0 +1,151 @@
+// ReachabilityIndex.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A ReachabilityIndex answers, in constant time, whether one vertex of a
+// CompactDigraph can reach another -- at least, whenever the answer can be
+// told cheaply -- so that a shortest path search isn't started (and left
+// to settle every vertex it can reach) only to find that there's no path.
+//
+// It's built in O(V + E) time from three facts about each vertex:
+//
+// * its strongly connected component, which every vertex in it reaches
+// * the level of that component: the length of the longest chain of
+//   components that can be reached from it, since a component that reaches
+//   another always has a higher level
+// * its weakly connected component (its component when the directions of
+//   the edges are ignored), outside of which it reaches nothing
+//
+// Components are numbered in reverse topological order, so a component
+// that reaches another also always has a higher number.  A query that none
+// of these tests settles is answered with Reachability::Unknown; only a
+// search can tell.
+
+#ifndef REACHABILITYINDEX_HPP
+#define REACHABILITYINDEX_HPP
+
+#include <algorithm>
+#include <vector>
+#include "CompactDigraph.hpp"
+
+
+
+enum class Reachability
+{
+    Reachable,
+    Unreachable,
+    Unknown
+};
+
+
+
+class ReachabilityIndex
+{
+public:
+    // The default constructor initializes an index of an empty graph.
+    ReachabilityIndex() = default;
+
+    // This constructor builds the index of the given graph, which needn't
+    // outlive it.
+    template <typename VertexInfo, typename EdgeInfo>
+    explicit ReachabilityIndex(const CompactDigraph<VertexInfo, EdgeInfo>& graph);
+
+    // reachability() tells whether the vertex at one index of the graph can
+    // reach the vertex at another.
+    Reachability reachability(int fromIndex, int toIndex) const noexcept;
+
+    // componentOf() returns the strongly connected component of the vertex
+    // at the given index, and componentCount() the number of components.
+    int componentOf(int index) const noexcept;
+    int componentCount() const noexcept;
+
+private:
+    std::vector<int> components_;
+    std::vector<int> levels_;
+    std::vector<int> weakComponents_;
+};
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+ReachabilityIndex::ReachabilityIndex(const CompactDigraph<VertexInfo, EdgeInfo>& graph)
+    : components_{graph.stronglyConnectedComponents()}
+{
+    int n = graph.vertexCount();
+    int count = n > 0 ? *std::max_element(components_.begin(), components_.end()) + 1 : 0;
+
+    // Every edge between components points to a lower-numbered one, so
+    // visiting the components in increasing order finishes the levels of
+    // the components an edge points to before the one it leaves.
+    std::vector<int> starts(count + 1, 0);
+    for (int component : components_)
+    {
+        starts[component + 1]++;
+    }
+    for (int c = 0; c < count; c++)
+    {
+        starts[c + 1] += starts[c];
+    }
+    std::vector<int> members(n);
+    std::vector<int> next(starts.begin(), starts.end() - 1);
+    for (int index = 0; index < n; index++)
+    {
+        members[next[components_[index]]++] = index;
+    }
+
+    levels_.assign(count, 0);
+    for (int c = 0; c < count; c++)
+    {
+        for (int i = starts[c]; i < starts[c + 1]; i++)
+        {
+            int index = members[i];
+            for (int edge = graph.edgeBegin(index); edge < graph.edgeEnd(index); edge++)
+            {
+                int target = components_[graph.edgeTarget(edge)];
+                if (target != c)
+                {
+                    levels_[c] = std::max(levels_[c], levels_[target] + 1);
+                }
+            }
+        }
+    }
+
+    // The weakly connected components are found by merging the two ends of
+    // every edge into one set, with path halving.
+    weakComponents_.resize(n);
+    for (int index = 0; index < n; index++)
+    {
+        weakComponents_[index] = index;
+    }
+    auto root =
+        [this](int index)
+        {
+            while (weakComponents_[index] != index)
+            {
+                weakComponents_[index] = weakComponents_[weakComponents_[index]];
+                index = weakComponents_[index];
+            }
+            return index;
+        };
+    for (int index = 0; index < n; index++)
+    {
+        for (int edge = graph.edgeBegin(index); edge < graph.edgeEnd(index); edge++)
+        {
+            int a = root(index);
+            int b = root(graph.edgeTarget(edge));
+            if (a != b)
+            {
+                weakComponents_[std::max(a, b)] = std::min(a, b);
+            }
+        }
+    }
+    for (int index = 0; index < n; index++)
+    {
+        weakComponents_[index] = root(index);
+    }
+}
+
+
+
+#endif // REACHABILITYINDEX_HPP
@@ -0,0 +1,322 @@
+// ReportWriter.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <charconv>
+#include "ReportWriter.hpp"
+
+
+namespace
+{
+    // The buffer is written to the stream whenever it holds at least this
+    // many bytes.
+    const std::size_t blockSize = 1 << 16;
+
+
+    // Rounds a number to the nearest tenth, the way the text report
+    // always has, as a float.
+    float roundTenths(double value)
+    {
+        float rounded = (int)(value * 10 + 0.5);
+        return rounded / 10;
+    }
+}
+
+
+ReportWriter::ReportWriter(std::ostream& out, const CompactRoadMap& roadMap, ReportFormat format)
+    : out_{out}, roadMap_{roadMap}, format_{format}
+{
+    buffer_.reserve(blockSize + blockSize / 2);
+
+    if (format_ == ReportFormat::Csv)
+    {
+        append("metric,from,to,found,total,segments,vertices\n");
+    }
+}
+
+
+ReportWriter::~ReportWriter() noexcept
+{
+    out_.write(buffer_.data(), buffer_.size());
+    out_.flush();
+}
+
+
+void ReportWriter::writeTrip(const Trip& trip, const DigraphPath& path)
+{
+    switch (format_)
+    {
+    case ReportFormat::Text:
+        writeText(trip, path);
+        break;
+
+    case ReportFormat::Csv:
+        writeCsv(trip, path);
+        break;
+
+    case ReportFormat::Json:
+        writeJson(trip, path);
+        break;
+    }
+
+    writeIfFull();
+}
+
+
+void ReportWriter::flush()
+{
+    out_.write(buffer_.data(), buffer_.size());
+    out_.flush();
+    buffer_.clear();
+}
+
+
+void ReportWriter::writeIfFull()
+{
+    if (buffer_.size() >= blockSize)
+    {
+        out_.write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+}
+
+
+void ReportWriter::writeText(const Trip& trip, const DigraphPath& path)
+{
+    bool distance = trip.metric == TripMetric::Distance;
+    const std::string& start = roadMap_.vertexInfo(trip.startVertex);
+
+    append(distance ? "Shortest distance from " : "Shortest driving time from ");
+    append(start);
+    append("to ");
+    append(roadMap_.vertexInfo(trip.endVertex));
+    append("\n");
+
+    if (!path.found())
+    {
+        append("  No route\n\n");
+        return;
+    }
+
+    append("  Begin at ");
+    append(start);
+    append("\n");
+
+    for (std::size_t i = 0; i < path.edges.size(); ++i)
+    {
+        const RoadSegment& segment = roadMap_.edgeInfoAt(path.edges[i]);
+
+        append("  Continue to ");
+        append(roadMap_.vertexInfo(path.vertices[i]));
+
+        if (distance)
+        {
+            if (segment.miles == 1)
+            {
+                append(" (1.0 mile)\n");
+            }
+            else
+            {
+                append(" (");
+                appendTenths(roundTenths(segment.miles));
+                append(" miles)\n");
+            }
+        }
+        else
+        {
+            append(" (");
+            appendTenths(roundTenths(segment.miles));
+            append(" miles @ ");
+            appendTenths(roundTenths(segment.milesPerHour));
+            append("mph = ");
+            appendTime(segment.miles / segment.milesPerHour);
+            append(")\n");
+        }
+    }
+
+    // The total is added up from the end of the path back to its start, as
+    // it always has been, so that it rounds the same way.
+    double total = 0.0;
+    for (std::size_t i = path.edges.size(); i > 0; --i)
+    {
+        const RoadSegment& segment = roadMap_.edgeInfoAt(path.edges[i - 1]);
+        total += distance ? segment.miles : segment.miles / segment.milesPerHour;
+    }
+
+    if (distance)
+    {
+        // This is how an output stream writes a double with a precision
+        // of 2: two significant digits, in either fixed or scientific
+        // notation, whichever is shorter.
+        char digits[32];
+        std::to_chars_result result =
+            std::to_chars(digits, digits + sizeof(digits), total, std::chars_format::general, 2);
+
+        append("Total distance: ");
+        append(std::string_view{digits, static_cast<std::size_t>(result.ptr - digits)});
+        append(" miles\n\n");
+    }
+    else
+    {
+        append("Total time: ");
+        appendTime(total);
+        append("\n\n");
+    }
+}
+
+
+void ReportWriter::writeCsv(const Trip& trip, const DigraphPath& path)
+{
+    append(trip.metric == TripMetric::Distance ? "distance," : "time,");
+    appendInt(trip.startVertex);
+    append(",");
+    appendInt(trip.endVertex);
+    append(path.found() ? ",1," : ",0,");
+    if (path.found())
+    {
+        appendExact(path.cost);
+    }
+    append(",");
+    appendInt(static_cast<int>(path.edges.size()));
+    append(",");
+
+    for (std::size_t i = 0; i < path.vertices.size(); ++i)
+    {
+        if (i > 0)
+        {
+            append(" ");
+        }
+        appendInt(path.vertices[i]);
+    }
+
+    append("\n");
+}
+
+
+void ReportWriter::writeJson(const Trip& trip, const DigraphPath& path)
+{
+    append(trip.metric == TripMetric::Distance ? "{\"metric\":\"distance\"" : "{\"metric\":\"time\"");
+    append(",\"from\":");
+    appendInt(trip.startVertex);
+    append(",\"to\":");
+    appendInt(trip.endVertex);
+    append(path.found() ? ",\"found\":true,\"total\":" : ",\"found\":false,\"total\":null");
+    if (path.found())
+    {
+        appendExact(path.cost);
+    }
+    append(",\"segments\":");
+    appendInt(static_cast<int>(path.edges.size()));
+    append(",\"vertices\":[");
+
+    for (std::size_t i = 0; i < path.vertices.size(); ++i)
+    {
+        if (i > 0)
+        {
+            append(",");
+        }
+        appendInt(path.vertices[i]);
+    }
+
+    append("]}\n");
+}
+
+
+void ReportWriter::append(std::string_view text)
+{
+    buffer_.append(text.data(), text.size());
+}
+
+
+void ReportWriter::appendInt(int value)
+{
+    char digits[16];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, result.ptr - digits);
+}
+
+
+void ReportWriter::appendTenths(float value)
+{
+    // The digit after the point is worked out with the same float
+    // arithmetic the text report has always used, so it comes out the
+    // same even where the float isn't exactly a number of tenths.
+    appendInt(int(value));
+    append(".");
+    appendInt(int((value - (int)value) * 10 + 0.5));
+}
+
+
+void ReportWriter::appendExact(double value)
+{
+    char digits[32];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, result.ptr - digits);
+}
+
+
+void ReportWriter::appendTime(double time)
+{
+    int hr = int(time);
+    int min = int((time - hr) * 60);
+    double sec = time * 3600 - hr * 3600 - min * 60;
+
+    if (hr != 0)
+    {
+        if (hr == 1)
+        {
+            append("1 hr ");
+        }
+        else
+        {
+            appendInt(hr);
+            append(" hrs ");
+        }
+
+        if (min == 1)
+        {
+            append("1 min ");
+        }
+        else
+        {
+            appendInt(min);
+            append(" mins ");
+        }
+
+        if (sec == 1)
+        {
+            append("1.0 sec");
+        }
+        else
+        {
+            // There's never been a space before "secs" when there are
+            // hours, and the report has to stay exactly as it was.
+            appendTenths(roundTenths(sec));
+            append("secs");
+        }
+    }
+    else
+    {
+        if (min == 1)
+        {
+            append("1 min ");
+        }
+        else if (min > 1)
+        {
+            appendInt(min);
+            append(" mins ");
+        }
+
+        if (sec == 1)
+        {
+            append("1.0 sec");
+        }
+        else
+        {
+            appendTenths(roundTenths(sec));
+            append(" secs");
+        }
+    }
+}
+
@@ -0,0 +1,103 @@
+// ReportWriter.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A ReportWriter writes the report of each trip the program evaluates to
+// an output stream.  Reports are formatted into a buffer that's reused
+// from one to the next, with std::to_chars() rather than std::to_string()
+// and string concatenation, and the buffer is written to the stream in
+// large blocks instead of being flushed after every line.
+//
+// There are three formats:
+//
+// * ReportFormat::Text is the human-readable report the program has
+//   always written, byte for byte: directions for each segment of the
+//   route, then its total distance or driving time.
+// * ReportFormat::Csv is a header line followed by one line per trip:
+//
+//       metric,from,to,found,total,segments,vertices
+//       distance,0,3,1,12.5,2,0 1 3
+//
+//   where metric is "distance" or "time", from and to are the trip's
+//   vertex numbers, found is 1 if there's a route and 0 if not, total is
+//   its length in miles or its driving time in hours (empty if there's no
+//   route), segments is the number of road segments along it, and
+//   vertices lists the vertex numbers along it, separated by spaces.
+// * ReportFormat::Json is one JSON object per line, with the same fields:
+//
+//       {"metric":"distance","from":0,"to":3,"found":true,"total":12.5,"segments":2,"vertices":[0,1,3]}
+//
+//   with a total of null if there's no route.
+//
+// The machine-readable formats write totals with as many digits as it
+// takes to read them back exactly.
+
+#ifndef REPORTWRITER_HPP
+#define REPORTWRITER_HPP
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "RoadMap.hpp"
+#include "Trip.hpp"
+
+
+
+enum class ReportFormat
+{
+    Text,
+    Csv,
+    Json
+};
+
+
+
+class ReportWriter
+{
+public:
+    // Initializes a ReportWriter that writes reports of trips on the given
+    // map, which must outlive it, to the given stream in the given format.
+    ReportWriter(std::ostream& out, const CompactRoadMap& roadMap, ReportFormat format = ReportFormat::Text);
+
+    // The destructor writes out anything still in the buffer.
+    ~ReportWriter() noexcept;
+
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+
+    // writeTrip() writes the report of the given trip, whose route is the
+    // given path (which may not have been found).
+    void writeTrip(const Trip& trip, const DigraphPath& path);
+
+    // flush() writes out anything still in the buffer and flushes the
+    // stream.
+    void flush();
+
+private:
+    std::ostream& out_;
+    const CompactRoadMap& roadMap_;
+    ReportFormat format_;
+    std::string buffer_;
+
+    //writes the buffer out once it holds a large enough block
+    void writeIfFull();
+
+    //the parts of each format's report
+    void writeText(const Trip& trip, const DigraphPath& path);
+    void writeCsv(const Trip& trip, const DigraphPath& path);
+    void writeJson(const Trip& trip, const DigraphPath& path);
+
+    //append text, an integer, a number that's been rounded to tenths
+    //(e.g., 3.5), a number with as many digits as it takes to read it
+    //back, and a driving time ("1 hr 5 mins 3.0 secs") to the buffer
+    void append(std::string_view text);
+    void appendInt(int value);
+    void appendTenths(float value);
+    void appendExact(double value);
+    void appendTime(double time);
+};
+
+
+
+#endif // REPORTWRITER_HPP
@@ -6,17 +6,48 @@
 // This header defines a type RoadMap, which is simply a typedef to a particular
 // instantiation of the Digraph template, where each vertex has a string for its
 // information and each edge has a RoadSegment for its information.
+//
+// It also defines CompactRoadMap, the matching CompactDigraph, which is the
+// read-only snapshot of a RoadMap that queries are answered against once
+// the map has been read.
+//
+// Finally, it defines DistanceWeight and TimeWeight, the edge weight
+// functions that correspond to the two TripMetrics.
 
 #ifndef ROADMAP_HPP
 #define ROADMAP_HPP
 
 #include <string>
 #include "Digraph.hpp"
+#include "CompactDigraph.hpp"
 #include "RoadSegment.hpp"
 
 
 
 typedef Digraph<std::string, RoadSegment> RoadMap;
+typedef CompactDigraph<std::string, RoadSegment> CompactRoadMap;
+
+
+
+// DistanceWeight weighs a RoadSegment by its length in miles; TimeWeight
+// weighs it by the time, in hours, that it takes to drive.
+
+struct DistanceWeight
+{
+    double operator()(const RoadSegment& segment) const noexcept
+    {
+        return segment.miles;
+    }
+};
+
+
+struct TimeWeight
+{
+    double operator()(const RoadSegment& segment) const noexcept
+    {
+        return segment.miles / segment.milesPerHour;
+    }
+};
 
 
 
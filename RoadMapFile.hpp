@@ -0,0 +1,96 @@
+// RoadMapFile.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This header file describes the binary road map file format, which holds
+// a CompactRoadMap laid out exactly as it's laid out in memory, so that a
+// file can be mapped into memory and queried right where it is, with no
+// parsing.  RoadMapWriter::writeBinaryRoadMap() writes one, and
+// RoadMapReader::mapBinaryRoadMap() maps one back into memory.
+//
+// A file begins with a RoadMapFileHeader, followed by these sections, for
+// a road map with n locations and m road segments:
+//
+// * ids (n ints): the location number of each index
+// * offsets (n + 1 ints), targets (m ints) and segments (m RoadSegments):
+//   the outgoing road segments of each index, in CSR form
+// * reverseOffsets (n + 1 ints), reverseSources (m ints) and reverseEdges
+//   (m ints): the incoming road segments of each index, in CSR form
+// * nameOffsets (n + 1 uint64_ts) and names (nameBytes chars): the string
+//   table, in which the name of the location at index i is the characters
+//   in the range [nameOffsets[i], nameOffsets[i + 1]) of names
+//
+// Each section starts at a multiple of 8 bytes from the beginning of the
+// file; the header records where.  Values are stored in the native byte
+// order of the machine that wrote the file, which the header also records,
+// so a file can only be mapped on a machine with the same byte order.
+
+#ifndef ROADMAPFILE_HPP
+#define ROADMAPFILE_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "RoadSegment.hpp"
+
+
+
+class RoadMapFileException : public std::runtime_error
+{
+public:
+    RoadMapFileException(const std::string& reason);
+};
+
+
+inline RoadMapFileException::RoadMapFileException(const std::string& reason)
+    : std::runtime_error{reason}
+{
+}
+
+
+
+struct RoadMapFileHeader
+{
+    char magic[8];
+    std::uint32_t byteOrder;
+    std::uint32_t version;
+
+    std::uint64_t vertexCount;
+    std::uint64_t edgeCount;
+    std::uint64_t nameBytes;
+
+    // where each section starts, in bytes from the beginning of the file
+    std::uint64_t ids;
+    std::uint64_t offsets;
+    std::uint64_t targets;
+    std::uint64_t segments;
+    std::uint64_t reverseOffsets;
+    std::uint64_t reverseSources;
+    std::uint64_t reverseEdges;
+    std::uint64_t nameOffsets;
+    std::uint64_t names;
+};
+
+
+// roadMapFileMagic is the first eight bytes of every road map file,
+// roadMapFileByteOrder is written in the writer's byte order (so that it
+// reads back differently on a machine whose byte order differs), and
+// roadMapFileVersion changes whenever the format does.
+constexpr char roadMapFileMagic[8] = {'R', 'O', 'A', 'D', 'M', 'A', 'P', '\0'};
+constexpr std::uint32_t roadMapFileByteOrder = 0x01020304;
+constexpr std::uint32_t roadMapFileVersion = 1;
+
+
+// The sections are copied straight into and out of memory, so the types
+// stored in them must have the same layout everywhere they're used.
+static_assert(sizeof(int) == 4, "road map files store 32-bit ints");
+static_assert(
+    std::is_trivially_copyable<RoadSegment>::value && sizeof(RoadSegment) == 16,
+    "road map files store RoadSegments as two doubles");
+
+
+
+#endif // ROADMAPFILE_HPP
+
@@ -0,0 +1,204 @@
+// RoadMapGeometry.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include "RoadMapGeometry.hpp"
+
+
+namespace
+{
+    const double earthRadiusMiles = 3958.8;
+    const double pi = 3.14159265358979323846;
+
+    double radians(double degrees)
+    {
+        return degrees * pi / 180.0;
+    }
+
+
+    // The Hilbert curve is drawn through a grid of this many squares on a
+    // side, a power of two.
+    const std::uint32_t hilbertGridSize = 1u << 16;
+
+
+    // Returns how far along the Hilbert curve through the grid the square
+    // in the given column and row is.  Each pass picks the quadrant the
+    // square is in at the next finer scale, then turns the square's
+    // position so that the curve through that quadrant has the same shape
+    // as the one through the whole grid.
+    std::uint64_t hilbertDistance(std::uint32_t x, std::uint32_t y)
+    {
+        std::uint64_t distance = 0;
+        for (std::uint32_t s = hilbertGridSize / 2; s > 0; s /= 2)
+        {
+            std::uint32_t rx = (x & s) != 0 ? 1 : 0;
+            std::uint32_t ry = (y & s) != 0 ? 1 : 0;
+            distance += static_cast<std::uint64_t>(s) * s * ((3 * rx) ^ ry);
+
+            if (ry == 0)
+            {
+                if (rx == 1)
+                {
+                    x = hilbertGridSize - 1 - x;
+                    y = hilbertGridSize - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return distance;
+    }
+
+
+    // Returns the column (or row) of the grid that the given coordinate
+    // falls in, given the lowest coordinate in the box and the width of
+    // each square.
+    std::uint32_t gridSquare(double coordinate, double low, double width)
+    {
+        double square = width > 0.0 ? (coordinate - low) / width : 0.0;
+        return static_cast<std::uint32_t>(std::min(square, static_cast<double>(hilbertGridSize - 1)));
+    }
+}
+
+
+void RoadMapGeometry::setLocation(int vertex, double latitude, double longitude)
+{
+    int index = indices.find(vertex);
+    if (index == -1)
+    {
+        indices.insert(vertex, static_cast<int>(locations.size()));
+        locations.push_back(Location{latitude, longitude});
+    }
+    else
+    {
+        locations[index] = Location{latitude, longitude};
+    }
+}
+
+
+bool RoadMapGeometry::hasLocation(int vertex) const noexcept
+{
+    return indices.find(vertex) != -1;
+}
+
+
+double RoadMapGeometry::milesBetween(int fromVertex, int toVertex) const noexcept
+{
+    int from = indices.find(fromVertex);
+    int to = indices.find(toVertex);
+
+    if (from == -1 || to == -1)
+    {
+        return 0.0;
+    }
+
+    // The haversine formula, which stays accurate for the short distances
+    // between neighboring locations.
+    double lat1 = radians(locations[from].latitude);
+    double lat2 = radians(locations[to].latitude);
+    double dLat = lat2 - lat1;
+    double dLon = radians(locations[to].longitude - locations[from].longitude);
+
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2)
+        + std::cos(lat1) * std::cos(lat2) * std::sin(dLon / 2) * std::sin(dLon / 2);
+
+    return 2 * earthRadiusMiles * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+
+std::vector<int> RoadMapGeometry::hilbertCurveOrder(const CompactRoadMap& roadMap) const
+{
+    int n = roadMap.vertexCount();
+
+    double lowLatitude = 0.0;
+    double highLatitude = 0.0;
+    double lowLongitude = 0.0;
+    double highLongitude = 0.0;
+    bool first = true;
+    for (int index = 0; index < n; ++index)
+    {
+        int location = indices.find(roadMap.vertexAt(index));
+        if (location != -1)
+        {
+            const Location& l = locations[location];
+            lowLatitude = first ? l.latitude : std::min(lowLatitude, l.latitude);
+            highLatitude = first ? l.latitude : std::max(highLatitude, l.latitude);
+            lowLongitude = first ? l.longitude : std::min(lowLongitude, l.longitude);
+            highLongitude = first ? l.longitude : std::max(highLongitude, l.longitude);
+            first = false;
+        }
+    }
+
+    double latitudeWidth = (highLatitude - lowLatitude) / hilbertGridSize;
+    double longitudeWidth = (highLongitude - lowLongitude) / hilbertGridSize;
+
+    // Sorting by (distance, index) pairs keeps the order the same from one
+    // run to the next even when two locations fall in the same square.
+    std::vector<std::pair<std::uint64_t, int>> keyed;
+    std::vector<int> unlocated;
+    keyed.reserve(n);
+    for (int index = 0; index < n; ++index)
+    {
+        int location = indices.find(roadMap.vertexAt(index));
+        if (location == -1)
+        {
+            unlocated.push_back(index);
+        }
+        else
+        {
+            const Location& l = locations[location];
+            std::uint32_t x = gridSquare(l.longitude, lowLongitude, longitudeWidth);
+            std::uint32_t y = gridSquare(l.latitude, lowLatitude, latitudeWidth);
+            keyed.push_back(std::make_pair(hilbertDistance(x, y), index));
+        }
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    std::vector<int> order;
+    order.reserve(n);
+    for (const std::pair<std::uint64_t, int>& entry : keyed)
+    {
+        order.push_back(entry.second);
+    }
+    order.insert(order.end(), unlocated.begin(), unlocated.end());
+    return order;
+}
+
+
+double maxMilesPerHour(const CompactRoadMap& roadMap)
+{
+    double fastest = 0.0;
+
+    for (int edge = 0; edge < roadMap.edgeCount(); ++edge)
+    {
+        fastest = std::max(fastest, roadMap.edgeInfoAt(edge).milesPerHour);
+    }
+
+    return fastest;
+}
+
+
+RoadMapHeuristic::RoadMapHeuristic(
+    const RoadMapGeometry& geometry, int endVertex, TripMetric metric,
+    double fastestMilesPerHour)
+    : geometry_{geometry}, endVertex_{endVertex},
+      scale_{1.0}
+{
+    if (metric == TripMetric::Time)
+    {
+        // Without any positive speed there's no bound to be had, but 0 is
+        // always a safe (if unhelpful) estimate.
+        scale_ = fastestMilesPerHour > 0.0 ? 1.0 / fastestMilesPerHour : 0.0;
+    }
+}
+
+
+double RoadMapHeuristic::operator()(int vertex) const noexcept
+{
+    return geometry_.milesBetween(vertex, endVertex_) * scale_;
+}
+
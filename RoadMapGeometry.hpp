@@ -0,0 +1,103 @@
+// RoadMapGeometry.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A RoadMapGeometry is a side table that records where on the Earth each
+// location in a RoadMap is, as a latitude and longitude in degrees.  The
+// RoadMap itself only knows the name of each location; the geometry is
+// kept separately, so that maps without it work exactly as before, and so
+// that it needn't cover every location.
+//
+// What geometry makes possible is goal-directed search.  The straight-line
+// (great-circle) distance between two locations can never be more than the
+// length of any road between them, so it's a lower bound on the remaining
+// cost that CompactDigraph::findShortestPathAStar() can use as its
+// heuristic.  RoadMapHeuristic packages that up for either TripMetric.
+
+#ifndef ROADMAPGEOMETRY_HPP
+#define ROADMAPGEOMETRY_HPP
+
+#include <vector>
+#include "RoadMap.hpp"
+#include "TripMetric.hpp"
+#include "VertexIndex.hpp"
+
+
+
+class RoadMapGeometry
+{
+public:
+    // setLocation() records the latitude and longitude (in degrees) of the
+    // location with the given vertex number, replacing any that was
+    // recorded for it before.
+    void setLocation(int vertex, double latitude, double longitude);
+
+    // hasLocation() returns true if a latitude and longitude have been
+    // recorded for the given vertex number, false otherwise.
+    bool hasLocation(int vertex) const noexcept;
+
+    // milesBetween() returns the great-circle distance, in miles, between
+    // the locations with the given vertex numbers.  If either one has no
+    // recorded location, nothing is known about the distance, so 0 is
+    // returned (which is still a valid lower bound).
+    double milesBetween(int fromVertex, int toVertex) const noexcept;
+
+    // hilbertCurveOrder() returns an order for the vertices of the given
+    // map (in the sense of VertexOrder.hpp, to be passed to renumbered())
+    // that follows a Hilbert curve through the box bounding the recorded
+    // locations.  The curve visits every small square of the box before
+    // moving on to the next, so locations that are close to each other
+    // mostly come close together in the order.  Vertices without a
+    // recorded location come last, in index order.
+    std::vector<int> hilbertCurveOrder(const CompactRoadMap& roadMap) const;
+
+private:
+    struct Location
+    {
+        double latitude;
+        double longitude;
+    };
+
+    VertexIndex indices;
+    std::vector<Location> locations;
+};
+
+
+
+// maxMilesPerHour() returns the highest speed on any road segment in the
+// given map, or 0 if the map has no road segments.
+
+double maxMilesPerHour(const CompactRoadMap& roadMap);
+
+
+
+// A RoadMapHeuristic is a heuristic function for findShortestPathAStar()
+// over a CompactRoadMap.  Given a vertex number, it returns a lower bound
+// on the cost of reaching a fixed end vertex under a TripMetric: the
+// great-circle distance for TripMetric::Distance, and the time it would
+// take to cover that distance at the map's top speed for TripMetric::Time.
+
+class RoadMapHeuristic
+{
+public:
+    // Initializes a RoadMapHeuristic for trips ending at the given vertex.
+    // For TripMetric::Time, fastestMilesPerHour must be at least as high
+    // as the speed on every segment (see maxMilesPerHour()), or the bound
+    // may overestimate.
+    RoadMapHeuristic(
+        const RoadMapGeometry& geometry, int endVertex, TripMetric metric,
+        double fastestMilesPerHour);
+
+    double operator()(int vertex) const noexcept;
+
+private:
+    const RoadMapGeometry& geometry_;
+    int endVertex_;
+    double scale_;
+};
+
+
+
+#endif // ROADMAPGEOMETRY_HPP
+
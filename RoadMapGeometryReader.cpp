@@ -0,0 +1,31 @@
+// RoadMapGeometryReader.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <sstream>
+#include "RoadMapGeometryReader.hpp"
+
+
+RoadMapGeometry RoadMapGeometryReader::readGeometry(InputReader& in)
+{
+    RoadMapGeometry geometry;
+
+    int numberOfLocations = in.readIntLine();
+
+    for (int i = 0; i < numberOfLocations; ++i)
+    {
+        std::istringstream locationLine{in.readLine()};
+
+        int vertex;
+        double latitude;
+        double longitude;
+
+        locationLine >> vertex >> latitude >> longitude;
+
+        geometry.setLocation(vertex, latitude, longitude);
+    }
+
+    return geometry;
+}
+
@@ -0,0 +1,29 @@
+// RoadMapGeometryReader.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// The RoadMapGeometryReader class reads a RoadMapGeometry in the same style
+// as the rest of the program's input: a line with the number of locations
+// that follow, then one line per location giving its vertex number, its
+// latitude and its longitude (in degrees), separated by spaces.
+
+#ifndef ROADMAPGEOMETRYREADER_HPP
+#define ROADMAPGEOMETRYREADER_HPP
+
+#include "RoadMapGeometry.hpp"
+#include "InputReader.hpp"
+
+
+
+class RoadMapGeometryReader
+{
+public:
+    // readGeometry() reads a RoadMapGeometry from the given InputReader.
+    RoadMapGeometry readGeometry(InputReader& in);
+};
+
+
+
+#endif // ROADMAPGEOMETRYREADER_HPP
+
@@ -0,0 +1,34 @@
+// RoadMapHierarchies.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include "RoadMapHierarchies.hpp"
+
+
+RoadMapHierarchies::RoadMapHierarchies(const CompactRoadMap& roadMap)
+    : distance_{roadMap, DistanceWeight{}}, time_{roadMap, TimeWeight{}}
+{
+}
+
+
+const RoadMapHierarchy& RoadMapHierarchies::hierarchy(TripMetric metric) const noexcept
+{
+    return metric == TripMetric::Distance ? distance_ : time_;
+}
+
+
+DigraphPath RoadMapHierarchies::findShortestPath(int startVertex, int endVertex, TripMetric metric) const
+{
+    return hierarchy(metric).findShortestPath(startVertex, endVertex);
+}
+
+
+DistanceMatrix RoadMapHierarchies::distanceMatrix(
+    const std::vector<int>& sourceVertices,
+    const std::vector<int>& targetVertices,
+    TripMetric metric, WorkStealingPool& pool) const
+{
+    return hierarchy(metric).distanceMatrix(sourceVertices, targetVertices, pool);
+}
+
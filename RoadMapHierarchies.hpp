@@ -0,0 +1,69 @@
+// RoadMapHierarchies.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A RoadMapHierarchies object holds the contraction hierarchies of one
+// CompactRoadMap: one for each TripMetric, since shortcuts that are right
+// for distance are generally wrong for driving time.  Building them is a
+// one-time cost paid when the map is loaded; afterward, any number of trips
+// can be answered against them, for either metric.
+//
+// It also defines RoadMapCustomizableHierarchy, the customizable kind of
+// contraction hierarchy over a CompactRoadMap, which suits a map whose
+// speeds keep changing (see LiveRoadMap.hpp): its expensive preprocessing
+// doesn't depend on the speeds, so keeping up with them only takes a call
+// to customize() with each new snapshot.
+
+#ifndef ROADMAPHIERARCHIES_HPP
+#define ROADMAPHIERARCHIES_HPP
+
+#include <string>
+#include <vector>
+#include "ContractionHierarchy.hpp"
+#include "CustomizableContractionHierarchy.hpp"
+#include "DistanceMatrix.hpp"
+#include "RoadMap.hpp"
+#include "TripMetric.hpp"
+#include "WorkStealingPool.hpp"
+
+
+
+typedef ContractionHierarchy<std::string, RoadSegment> RoadMapHierarchy;
+typedef CustomizableContractionHierarchy<std::string, RoadSegment> RoadMapCustomizableHierarchy;
+
+
+
+class RoadMapHierarchies
+{
+public:
+    // Builds both hierarchies for the given map, which must outlive this
+    // RoadMapHierarchies object.
+    explicit RoadMapHierarchies(const CompactRoadMap& roadMap);
+
+    // hierarchy() returns the hierarchy for the given TripMetric.
+    const RoadMapHierarchy& hierarchy(TripMetric metric) const noexcept;
+
+    // findShortestPath() returns a shortest path from the start vertex to
+    // the end vertex under the given TripMetric.  If either vertex does
+    // not exist, a DigraphException is thrown instead.
+    DigraphPath findShortestPath(int startVertex, int endVertex, TripMetric metric) const;
+
+    // distanceMatrix() returns the cost of a shortest path from each of the
+    // source vertices to each of the target vertices under the given
+    // TripMetric, using the workers of the given WorkStealingPool.  If any
+    // of the vertices does not exist, a DigraphException is thrown instead.
+    DistanceMatrix distanceMatrix(
+        const std::vector<int>& sourceVertices,
+        const std::vector<int>& targetVertices,
+        TripMetric metric, WorkStealingPool& pool) const;
+
+private:
+    RoadMapHierarchy distance_;
+    RoadMapHierarchy time_;
+};
+
+
+
+#endif // ROADMAPHIERARCHIES_HPP
+
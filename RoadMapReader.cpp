@@ -4,13 +4,23 @@
 // Project #5: Rock and Roll Stops the Traffic
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <sstream>
+#include <string_view>
+#include <vector>
+#include "DigraphBuilder.hpp"
+#include "MappedFile.hpp"
+#include "RoadMapFile.hpp"
 #include "RoadMapReader.hpp"
 
 
 RoadMap RoadMapReader::readRoadMap(InputReader& in)
 {
-    RoadMap roadMap;
+    DigraphBuilder<std::string, RoadSegment> roadMap;
 
     int numberOfLocations = in.readIntLine();
 
@@ -35,6 +45,133 @@ RoadMap RoadMapReader::readRoadMap(InputReader& in)
         roadMap.addEdge(fromLocation, toLocation, RoadSegment{miles, milesPerHour});
     }
 
-    return roadMap;
+    return roadMap.build();
 }
 
+
+RoadMap RoadMapReader::readRoadMap(InputScanner& in)
+{
+    DigraphBuilder<std::string, RoadSegment> roadMap;
+
+    int numberOfLocations = in.readIntLine();
+    int locationsToReserve = in.capLineCount(numberOfLocations);
+    roadMap.reserve(locationsToReserve, 0);
+
+    for (int i = 0; i < numberOfLocations; ++i)
+    {
+        roadMap.addVertex(i, std::string{in.readLine()});
+    }
+
+    int numberOfRoadSegments = in.readIntLine();
+    roadMap.reserve(locationsToReserve, in.capLineCount(numberOfRoadSegments));
+
+    for (int i = 0; i < numberOfRoadSegments; ++i)
+    {
+        std::string_view roadSegmentLine = in.readLine();
+
+        int fromLocation = InputScanner::takeInt(roadSegmentLine);
+        int toLocation = InputScanner::takeInt(roadSegmentLine);
+        double miles = InputScanner::takeDouble(roadSegmentLine);
+        double milesPerHour = InputScanner::takeDouble(roadSegmentLine);
+
+        roadMap.addEdge(fromLocation, toLocation, RoadSegment{miles, milesPerHour});
+    }
+
+    return roadMap.build();
+}
+
+
+
+namespace
+{
+    // Returns a CompactArray referring to the given number of values of
+    // type T, starting at the given position in the file, after checking
+    // that the file actually holds them there.
+    template <typename T>
+    CompactArray<T> mapSection(
+        const std::shared_ptr<const MappedFile>& file,
+        std::uint64_t start, std::uint64_t count)
+    {
+        std::uint64_t size = file->size();
+        if (start % alignof(T) != 0
+            || start > size
+            || count > (size - start) / sizeof(T))
+        {
+            throw RoadMapFileException("Road map file is truncated or corrupt");
+        }
+
+        return CompactArray<T>{
+            file,
+            reinterpret_cast<const T*>(file->data() + start),
+            static_cast<std::size_t>(count)};
+    }
+}
+
+
+CompactRoadMap RoadMapReader::mapBinaryRoadMap(const std::string& path)
+{
+    std::shared_ptr<const MappedFile> file = std::make_shared<const MappedFile>(path);
+
+    RoadMapFileHeader header;
+    if (file->size() < sizeof(header))
+    {
+        throw RoadMapFileException(path + " is not a road map file");
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+
+    if (!std::equal(std::begin(roadMapFileMagic), std::end(roadMapFileMagic), header.magic))
+    {
+        throw RoadMapFileException(path + " is not a road map file");
+    }
+    if (header.byteOrder != roadMapFileByteOrder)
+    {
+        throw RoadMapFileException(path + " was written on a machine with a different byte order");
+    }
+    if (header.version != roadMapFileVersion)
+    {
+        throw RoadMapFileException(path + " has unsupported version " + std::to_string(header.version));
+    }
+
+    std::uint64_t n = header.vertexCount;
+    std::uint64_t m = header.edgeCount;
+    if (n >= static_cast<std::uint64_t>(std::numeric_limits<int>::max())
+        || m > static_cast<std::uint64_t>(std::numeric_limits<int>::max()))
+    {
+        throw RoadMapFileException(path + " is too large");
+    }
+
+    CompactDigraphArrays<std::string, RoadSegment> arrays;
+    arrays.ids = mapSection<int>(file, header.ids, n);
+    arrays.offsets = mapSection<int>(file, header.offsets, n + 1);
+    arrays.targets = mapSection<int>(file, header.targets, m);
+    arrays.einfos = mapSection<RoadSegment>(file, header.segments, m);
+    arrays.reverseOffsets = mapSection<int>(file, header.reverseOffsets, n + 1);
+    arrays.reverseSources = mapSection<int>(file, header.reverseSources, m);
+    arrays.reverseEdges = mapSection<int>(file, header.reverseEdges, m);
+
+    // The names are the only thing copied out of the file, since a
+    // CompactRoadMap hands them out as std::strings.
+    CompactArray<std::uint64_t> nameOffsets = mapSection<std::uint64_t>(file, header.nameOffsets, n + 1);
+    CompactArray<char> names = mapSection<char>(file, header.names, header.nameBytes);
+
+    std::vector<std::string> vertexInfos;
+    vertexInfos.reserve(n);
+    for (std::uint64_t i = 0; i < n; ++i)
+    {
+        if (nameOffsets[i] > nameOffsets[i + 1] || nameOffsets[i + 1] > names.size())
+        {
+            throw RoadMapFileException("Road map file is truncated or corrupt");
+        }
+        vertexInfos.emplace_back(names.data() + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]);
+    }
+    arrays.vinfos = CompactArray<std::string>{std::move(vertexInfos)};
+
+    try
+    {
+        return CompactRoadMap{std::move(arrays)};
+    }
+    catch (DigraphException&)
+    {
+        throw RoadMapFileException("Road map file is truncated or corrupt");
+    }
+}
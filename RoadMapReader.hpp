@@ -5,13 +5,16 @@
 //
 // The RoadMapReader class provides an object that knows how to read a
 // RoadMap from the standard input, using the format given in the
-// project write-up.
+// project write-up, or how to load a CompactRoadMap from a binary road map
+// file written by RoadMapWriter.
 
 #ifndef ROADMAPREADER_HPP
 #define ROADMAPREADER_HPP
 
+#include <string>
 #include "RoadMap.hpp"
 #include "InputReader.hpp"
+#include "InputScanner.hpp"
 
 
 
@@ -22,6 +25,22 @@ public:
     // RoadMap is expected to be described in the format given in the
     // project write-up.
     RoadMap readRoadMap(InputReader& in);
+
+    // This overload of readRoadMap() reads the RoadMap from an
+    // InputScanner, which is much faster for a large road map.  Storage
+    // for the locations and road segments is reserved as soon as their
+    // numbers are read.
+    RoadMap readRoadMap(InputScanner& in);
+
+    // mapBinaryRoadMap() maps the binary road map file with the given path
+    // (see RoadMapFile.hpp) into memory and returns a CompactRoadMap whose
+    // arrays refer directly to the mapped file, which stays mapped for as
+    // long as the CompactRoadMap (or any copy of it) is around.  Only the
+    // location names are copied out of the file.  A file that can't be
+    // mapped, or whose header doesn't describe a road map file this program
+    // can read, causes a MappedFileException or a RoadMapFileException to
+    // be thrown; the contents of the sections themselves are trusted.
+    CompactRoadMap mapBinaryRoadMap(const std::string& path);
 };
 
 
@@ -3,31 +3,149 @@
 // ICS 46 Winter 2021
 // Project #5: Rock and Roll Stops the Traffic
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "RoadMapFile.hpp"
 #include "RoadMapWriter.hpp"
 
 
 void RoadMapWriter::writeRoadMap(std::ostream& out, const RoadMap& roadMap)
 {
-    out << "LOCATIONS" << std::endl;
+    // The map is walked through its views, which hand over each location's
+    // name and each segment's RoadSegment in place, so that writing it
+    // takes O(V + E) time; lines end with '\n' rather than std::endl,
+    // which would flush the stream after every one of them.
+    out << "LOCATIONS" << '\n';
 
-    for (int vertex : roadMap.vertices())
+    for (DigraphVertexEntry<std::string> vertex : roadMap.vertexRange())
     {
-        out << "    " << vertex << ": " << roadMap.vertexInfo(vertex) << std::endl;
+        out << "    " << vertex.vertex << ": " << vertex.vinfo << '\n';
     }
 
-    out << std::endl;
-    out << "ROAD SEGMENTS" << std::endl;
+    out << '\n';
+    out << "ROAD SEGMENTS" << '\n';
+
+    // edgeRange() gives the segments a location at a time, but they're
+    // written in the order they were added (the order of edges()), so each
+    // is first put in its place by the position its DigraphEdge records.
+    std::vector<const DigraphEdge<RoadSegment>*> segments;
+    segments.reserve(roadMap.edgeCount());
 
-    for (std::pair<int, int> edge : roadMap.edges())
+    for (const DigraphEdge<RoadSegment>& edge : roadMap.edgeRange())
     {
-        out << "    " << edge.first << "," << edge.second << ": ";
+        std::size_t position = static_cast<std::size_t>(edge.position);
 
-        RoadSegment segment = roadMap.edgeInfo(edge.first, edge.second);
-        out << segment.miles << "miles; " << segment.milesPerHour << "mph";
+        if (position >= segments.size())
+        {
+            segments.resize(position + 1, nullptr);
+        }
 
-        out << std::endl;
+        segments[position] = &edge;
+    }
+
+    for (const DigraphEdge<RoadSegment>* edge : segments)
+    {
+        if (edge != nullptr)
+        {
+            out << "    " << edge->fromVertex << "," << edge->toVertex << ": ";
+            out << edge->einfo.miles << "miles; " << edge->einfo.milesPerHour << "mph";
+            out << '\n';
+        }
     }
 
     out << std::endl;
 }
 
+
+
+namespace
+{
+    // Sections of a binary road map file start at multiples of this many
+    // bytes.
+    const std::uint64_t sectionAlignment = 8;
+
+
+    std::uint64_t alignSection(std::uint64_t position)
+    {
+        return (position + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+    }
+
+
+    // Places a section of the given number of bytes after the one that ends
+    // at the given position, returning where it starts and moving the
+    // position past it.
+    std::uint64_t placeSection(std::uint64_t& position, std::uint64_t bytes)
+    {
+        std::uint64_t start = alignSection(position);
+        position = start + bytes;
+        return start;
+    }
+
+
+    // Writes a section, preceded by zeros from the given position (where
+    // the last section ended) up to where the section starts.
+    void writeSection(
+        std::ostream& out, std::uint64_t& position, std::uint64_t start,
+        const void* data, std::uint64_t bytes)
+    {
+        static const char padding[sectionAlignment] = {};
+        out.write(padding, static_cast<std::streamsize>(start - position));
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        position = start + bytes;
+    }
+}
+
+
+void RoadMapWriter::writeBinaryRoadMap(std::ostream& out, const CompactRoadMap& roadMap)
+{
+    CompactDigraphArrays<std::string, RoadSegment> arrays = roadMap.arrays();
+    std::uint64_t n = arrays.ids.size();
+    std::uint64_t m = arrays.targets.size();
+
+    std::vector<std::uint64_t> nameOffsets;
+    nameOffsets.reserve(n + 1);
+    nameOffsets.push_back(0);
+    for (const std::string& name : arrays.vinfos)
+    {
+        nameOffsets.push_back(nameOffsets.back() + name.size());
+    }
+
+    RoadMapFileHeader header{};
+    std::copy(std::begin(roadMapFileMagic), std::end(roadMapFileMagic), header.magic);
+    header.byteOrder = roadMapFileByteOrder;
+    header.version = roadMapFileVersion;
+    header.vertexCount = n;
+    header.edgeCount = m;
+    header.nameBytes = nameOffsets.back();
+
+    std::uint64_t position = sizeof(RoadMapFileHeader);
+    header.ids = placeSection(position, n * sizeof(int));
+    header.offsets = placeSection(position, (n + 1) * sizeof(int));
+    header.targets = placeSection(position, m * sizeof(int));
+    header.segments = placeSection(position, m * sizeof(RoadSegment));
+    header.reverseOffsets = placeSection(position, (n + 1) * sizeof(int));
+    header.reverseSources = placeSection(position, m * sizeof(int));
+    header.reverseEdges = placeSection(position, m * sizeof(int));
+    header.nameOffsets = placeSection(position, (n + 1) * sizeof(std::uint64_t));
+    header.names = placeSection(position, header.nameBytes);
+
+    position = 0;
+    writeSection(out, position, 0, &header, sizeof(header));
+    writeSection(out, position, header.ids, arrays.ids.data(), n * sizeof(int));
+    writeSection(out, position, header.offsets, arrays.offsets.data(), (n + 1) * sizeof(int));
+    writeSection(out, position, header.targets, arrays.targets.data(), m * sizeof(int));
+    writeSection(out, position, header.segments, arrays.einfos.data(), m * sizeof(RoadSegment));
+    writeSection(out, position, header.reverseOffsets, arrays.reverseOffsets.data(), (n + 1) * sizeof(int));
+    writeSection(out, position, header.reverseSources, arrays.reverseSources.data(), m * sizeof(int));
+    writeSection(out, position, header.reverseEdges, arrays.reverseEdges.data(), m * sizeof(int));
+    writeSection(out, position, header.nameOffsets, nameOffsets.data(), (n + 1) * sizeof(std::uint64_t));
+
+    for (const std::string& name : arrays.vinfos)
+    {
+        out.write(name.data(), static_cast<std::streamsize>(name.size()));
+    }
+}
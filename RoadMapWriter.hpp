@@ -7,6 +7,9 @@
 // stream in a format that allows you to see information about it.  This
 // is provided purely as a debugging aid; you don't actually need it to
 // solve the problem at hand.
+//
+// A RoadMapWriter can also write a road map in the binary road map file
+// format, which can be loaded far faster than the text format.
 
 #ifndef ROADMAPWRITER_HPP
 #define ROADMAPWRITER_HPP
@@ -23,6 +26,12 @@ public:
     // you could pass std::cout to write it to the console) in a format
     // that's designed to assist in debugging.
     void writeRoadMap(std::ostream& out, const RoadMap& roadMap);
+
+    // writeBinaryRoadMap() writes a CompactRoadMap to the given output
+    // stream, which should be opened in binary mode, in the binary road map
+    // file format described in RoadMapFile.hpp.  RoadMapReader can then map
+    // the file back into memory with mapBinaryRoadMap().
+    void writeBinaryRoadMap(std::ostream& out, const CompactRoadMap& roadMap);
 };
 
 
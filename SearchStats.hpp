@@ -0,0 +1,152 @@
+// SearchStats.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This header file declares the two kinds of statistics that a
+// BasicDijkstraWorkspace can keep about the search it's running, one of
+// which is its second template parameter.
+//
+// * NoSearchStats, the default, keeps none.  All of its member functions
+//   are inline and do nothing, so a search compiled with it has nothing
+//   left of them, and costs exactly what it did before there were stats.
+// * SearchStats counts the work the search does: the vertices settled, the
+//   edges relaxed, the pushes onto and pops from its priority queue, and
+//   the pops that are stale (i.e., of a vertex already settled, so they're
+//   wasted).  It also times the search itself and the reconstruction of
+//   paths afterward.
+//
+// A search counts into its workspace's stats as it goes, and resetting
+// the workspace (which every search does as it starts) zeroes them, so
+// after a query they describe that query.  A search that runs in two
+// workspaces (e.g., a bidirectional one) counts into both, and its stats
+// are the two added together.
+
+#ifndef SEARCHSTATS_HPP
+#define SEARCHSTATS_HPP
+
+#include <chrono>
+
+
+
+struct NoSearchStats
+{
+    void countSettle() noexcept { }
+    void countRelax() noexcept { }
+    void countPush() noexcept { }
+    void countPop() noexcept { }
+    void countStalePop() noexcept { }
+
+    void startSearch() noexcept { }
+    void stopSearch() noexcept { }
+    void startPaths() noexcept { }
+    void stopPaths() noexcept { }
+};
+
+
+
+struct SearchStats
+{
+    long long settled = 0;
+    long long relaxed = 0;
+    long long pushes = 0;
+    long long pops = 0;
+    long long stalePops = 0;
+
+    // the time spent searching, and reconstructing paths, in seconds
+    double searchSeconds = 0.0;
+    double pathSeconds = 0.0;
+
+    // when the phase being timed began
+    std::chrono::steady_clock::time_point started;
+
+    // The count functions each add one to a count; a stale pop counts as
+    // a pop, too.
+    void countSettle() noexcept;
+    void countRelax() noexcept;
+    void countPush() noexcept;
+    void countPop() noexcept;
+    void countStalePop() noexcept;
+
+    // The start and stop functions bracket a phase of the work, whose time
+    // is added to searchSeconds or pathSeconds.
+    void startSearch() noexcept;
+    void stopSearch() noexcept;
+    void startPaths() noexcept;
+    void stopPaths() noexcept;
+
+    // operator+= adds the counts and times of other to these.
+    SearchStats& operator+=(const SearchStats& other) noexcept;
+};
+
+
+
+inline void SearchStats::countSettle() noexcept
+{
+    settled++;
+}
+
+
+inline void SearchStats::countRelax() noexcept
+{
+    relaxed++;
+}
+
+
+inline void SearchStats::countPush() noexcept
+{
+    pushes++;
+}
+
+
+inline void SearchStats::countPop() noexcept
+{
+    pops++;
+}
+
+
+inline void SearchStats::countStalePop() noexcept
+{
+    stalePops++;
+}
+
+
+inline void SearchStats::startSearch() noexcept
+{
+    started = std::chrono::steady_clock::now();
+}
+
+
+inline void SearchStats::stopSearch() noexcept
+{
+    searchSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+
+inline void SearchStats::startPaths() noexcept
+{
+    started = std::chrono::steady_clock::now();
+}
+
+
+inline void SearchStats::stopPaths() noexcept
+{
+    pathSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+
+inline SearchStats& SearchStats::operator+=(const SearchStats& other) noexcept
+{
+    settled += other.settled;
+    relaxed += other.relaxed;
+    pushes += other.pushes;
+    pops += other.pops;
+    stalePops += other.stalePops;
+    searchSeconds += other.searchSeconds;
+    pathSeconds += other.pathSeconds;
+    return *this;
+}
+
+
+
+#endif // SEARCHSTATS_HPP
@@ -0,0 +1,30 @@
+// ShortestPathTree.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A ShortestPathTree is the complete outcome of a single-source shortest
+// path search over a CompactDigraph: for each vertex index, its distance
+// from the start vertex and its predecessor on the shortest path found
+// (-1 for the start vertex itself and for any vertex that can't be reached
+// from it).  Once built, a tree can answer a path query to any end vertex
+// without searching again; see CompactDigraph::pathTo().
+
+#ifndef SHORTESTPATHTREE_HPP
+#define SHORTESTPATHTREE_HPP
+
+#include <vector>
+
+
+
+struct ShortestPathTree
+{
+    int startIndex;
+    std::vector<double> distance;
+    std::vector<int> predecessor;
+};
+
+
+
+#endif // SHORTESTPATHTREE_HPP
+
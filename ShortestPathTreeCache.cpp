@@ -0,0 +1,84 @@
+// ShortestPathTreeCache.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include "ShortestPathTreeCache.hpp"
+
+
+ShortestPathTreeCache::ShortestPathTreeCache(int capacity)
+    : capacity_{capacity}
+{
+}
+
+
+int ShortestPathTreeCache::capacity() const noexcept
+{
+    return capacity_;
+}
+
+
+void ShortestPathTreeCache::setCapacity(int capacity)
+{
+    capacity_ = capacity;
+    trim();
+}
+
+
+int ShortestPathTreeCache::size() const noexcept
+{
+    return static_cast<int>(positions_.size());
+}
+
+
+std::shared_ptr<const ShortestPathTree> ShortestPathTreeCache::find(int startVertex, TripMetric metric)
+{
+    auto position = positions_.find(Key{startVertex, metric});
+
+    if (position == positions_.end())
+    {
+        return nullptr;
+    }
+
+    entries_.splice(entries_.begin(), entries_, position->second);
+    return position->second->second;
+}
+
+
+void ShortestPathTreeCache::insert(int startVertex, TripMetric metric, std::shared_ptr<const ShortestPathTree> tree)
+{
+    Key key{startVertex, metric};
+    auto position = positions_.find(key);
+
+    if (position != positions_.end())
+    {
+        position->second->second = std::move(tree);
+        entries_.splice(entries_.begin(), entries_, position->second);
+    }
+    else
+    {
+        entries_.emplace_front(key, std::move(tree));
+        positions_[key] = entries_.begin();
+    }
+
+    trim();
+}
+
+
+void ShortestPathTreeCache::clear() noexcept
+{
+    entries_.clear();
+    positions_.clear();
+}
+
+
+void ShortestPathTreeCache::trim()
+{
+    while (static_cast<int>(positions_.size()) > std::max(capacity_, 0))
+    {
+        positions_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+}
+
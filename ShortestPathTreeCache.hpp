@@ -0,0 +1,71 @@
+// ShortestPathTreeCache.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A ShortestPathTreeCache keeps the ShortestPathTrees of recently searched
+// start vertices, one per start vertex and TripMetric, so that later trips
+// from the same start vertex can be answered without searching at all.
+// It holds at most a fixed number of trees; when it's full, adding another
+// discards the one that was least recently used.
+//
+// Trees are shared (through std::shared_ptr) rather than copied, so one
+// that's discarded from the cache stays valid for anyone still using it.
+
+#ifndef SHORTESTPATHTREECACHE_HPP
+#define SHORTESTPATHTREECACHE_HPP
+
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+#include "ShortestPathTree.hpp"
+#include "TripMetric.hpp"
+
+
+
+class ShortestPathTreeCache
+{
+public:
+    // Initializes an empty cache that holds at most the given number of
+    // trees; a capacity of 0 means the cache never holds any.
+    explicit ShortestPathTreeCache(int capacity = 0);
+
+    // capacity() returns the most trees the cache will hold.
+    int capacity() const noexcept;
+
+    // setCapacity() changes the most trees the cache will hold, discarding
+    // the least recently used ones if there are now too many.
+    void setCapacity(int capacity);
+
+    // size() returns the number of trees the cache holds.
+    int size() const noexcept;
+
+    // find() returns the tree for the given start vertex and metric, which
+    // becomes the most recently used, or nullptr if there's no such tree.
+    std::shared_ptr<const ShortestPathTree> find(int startVertex, TripMetric metric);
+
+    // insert() adds the tree for the given start vertex and metric as the
+    // most recently used, replacing any tree already there for them.
+    void insert(int startVertex, TripMetric metric, std::shared_ptr<const ShortestPathTree> tree);
+
+    // clear() discards every tree.
+    void clear() noexcept;
+
+private:
+    typedef std::pair<int, TripMetric> Key;
+    typedef std::list<std::pair<Key, std::shared_ptr<const ShortestPathTree>>> Entries;
+
+    // entries is ordered from most to least recently used
+    int capacity_;
+    Entries entries_;
+    std::map<Key, Entries::iterator> positions_;
+
+    //discards least recently used trees down to the capacity
+    void trim();
+};
+
+
+
+#endif // SHORTESTPATHTREECACHE_HPP
+
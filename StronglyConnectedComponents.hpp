@@ -0,0 +1,113 @@
+// StronglyConnectedComponents.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This header file declares a function template that finds the strongly
+// connected components of a directed graph given in CSR form, using
+// Tarjan's algorithm.  Both Digraph and CompactDigraph use it.
+//
+// The depth-first search is driven by an explicit stack rather than by
+// recursion, so a long chain of vertices (e.g., a road hundreds of
+// thousands of segments long) can't overflow the call stack, and it
+// takes O(V + E) time and O(V) extra space.
+
+#ifndef STRONGLYCONNECTEDCOMPONENTS_HPP
+#define STRONGLYCONNECTEDCOMPONENTS_HPP
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+
+
+// findStronglyConnectedComponents() takes the number of vertices n and the
+// outgoing edges of the vertices with indices [0, n) in CSR form: the
+// edges leaving index i are [offsets[i], offsets[i + 1]), and targets holds
+// the index each edge points to.  It returns the component of every index,
+// numbered from 0.  Components are numbered in reverse topological order,
+// so an edge from one component to another always points to the component
+// with the lower number.
+
+template <typename Offsets, typename Targets>
+std::vector<int> findStronglyConnectedComponents(
+    int n, const Offsets& offsets, const Targets& targets)
+{
+    // discovered[i] is the order in which index i was first reached (or
+    // -1), and lowest[i] is the lowest such order reachable from it within
+    // its subtree.  An index that's been reached but doesn't have a
+    // component yet is still on the stack of open indices.
+    std::vector<int> component(n, -1);
+    std::vector<int> discovered(n, -1);
+    std::vector<int> lowest(n, 0);
+    std::vector<int> open;
+
+    // Each frame of the search is an index and the next of its edges to
+    // follow.
+    std::vector<std::pair<int, int>> frames;
+    int found = 0;
+    int components = 0;
+
+    for(int root = 0; root < n; root++)
+    {
+        if(discovered[root] != -1)
+        {
+            continue;
+        }
+
+        discovered[root] = lowest[root] = found++;
+        open.push_back(root);
+        frames.push_back(std::make_pair(root, static_cast<int>(offsets[root])));
+
+        while(!frames.empty())
+        {
+            int index = frames.back().first;
+            int edge = frames.back().second;
+
+            if(edge < offsets[index + 1])
+            {
+                frames.back().second++;
+                int w = targets[edge];
+                if(discovered[w] == -1)
+                {
+                    discovered[w] = lowest[w] = found++;
+                    open.push_back(w);
+                    frames.push_back(std::make_pair(w, static_cast<int>(offsets[w])));
+                }
+                else if(component[w] == -1)
+                {
+                    lowest[index] = std::min(lowest[index], discovered[w]);
+                }
+                continue;
+            }
+
+            // Every edge of index has been followed.  If nothing in its
+            // subtree reaches back above it, it and everything still open
+            // above it on the stack make up a component.
+            frames.pop_back();
+            if(lowest[index] == discovered[index])
+            {
+                int w;
+                do
+                {
+                    w = open.back();
+                    open.pop_back();
+                    component[w] = components;
+                }
+                while(w != index);
+                components++;
+            }
+            if(!frames.empty())
+            {
+                int parent = frames.back().first;
+                lowest[parent] = std::min(lowest[parent], lowest[index]);
+            }
+        }
+    }
+
+    return component;
+}
+
+
+
+#endif // STRONGLYCONNECTEDCOMPONENTS_HPP
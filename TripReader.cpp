@@ -5,6 +5,7 @@
 
 #include <sstream>
 #include <string>
+#include <string_view>
 #include "TripReader.hpp"
 
 
@@ -32,3 +33,27 @@ std::vector<Trip> TripReader::readTrips(InputReader& in)
     return trips;
 }
 
+
+
+std::vector<Trip> TripReader::readTrips(InputScanner& in)
+{
+    std::vector<Trip> trips;
+
+    int numberOfTrips = in.readIntLine();
+    trips.reserve(in.capLineCount(numberOfTrips));
+
+    for (int i = 0; i < numberOfTrips; ++i)
+    {
+        std::string_view tripLine = in.readLine();
+
+        int fromVertex = InputScanner::takeInt(tripLine);
+        int toVertex = InputScanner::takeInt(tripLine);
+        std::string_view metricType = InputScanner::takeWord(tripLine);
+
+        trips.push_back(
+            {fromVertex, toVertex,
+             metricType == "D" ? TripMetric::Distance : TripMetric::Time});
+    }
+
+    return trips;
+}
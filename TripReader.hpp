@@ -12,6 +12,7 @@
 #include <vector>
 #include "Trip.hpp"
 #include "InputReader.hpp"
+#include "InputScanner.hpp"
 
 
 
@@ -21,6 +22,9 @@ public:
     // readTrips() reads a sequence of trips from the given input,
     // returning them as a vector of Trip structs.
     std::vector<Trip> readTrips(InputReader& in);    
+
+    // This overload of readTrips() reads them from an InputScanner.
+    std::vector<Trip> readTrips(InputScanner& in);
 };
 
 
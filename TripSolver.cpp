@@ -0,0 +1,297 @@
+// TripSolver.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include "TripSolver.hpp"
+
+
+namespace
+{
+    // A TripGroup is a run of trips, [begin, end) in the sorted order,
+    // that share a start vertex and a metric; tree is their cached tree,
+    // if they have one.
+    struct TripGroup
+    {
+        int begin;
+        int end;
+        std::shared_ptr<const ShortestPathTree> tree;
+        bool searched;
+    };
+
+
+    // The average weight of the road segments in a column is the bucket
+    // width a TripSolver starts out with (or 1, if there are none).
+    double averageWeight(const EdgeWeightColumn& weights)
+    {
+        double total = 0.0;
+        for (std::size_t i = 0; i < weights.size(); ++i)
+        {
+            total += weights[i];
+        }
+        return total > 0.0 ? total / weights.size() : 1.0;
+    }
+
+
+    // solveGroup() finds the paths for the trips in a group, searching in
+    // the given workspace unless they have a tree already (or are to get
+    // one, if caching), and leaves the work that took in its stats.
+    template <typename Workspace>
+    void solveGroup(
+        const CompactRoadMap& roadMap, const EdgeWeightColumn& weights,
+        const std::vector<Trip>& trips, const std::vector<int>& order,
+        TripGroup& group, bool caching, std::vector<DigraphPath>& paths,
+        Workspace& workspace)
+    {
+        const Trip& first = trips[order[group.begin]];
+        workspace.stats = decltype(workspace.stats){};
+
+        if (group.tree == nullptr && caching)
+        {
+            group.tree = std::make_shared<const ShortestPathTree>(
+                roadMap.findShortestPathTree(first.startVertex, weights, workspace));
+        }
+
+        if (group.tree != nullptr)
+        {
+            workspace.stats.startPaths();
+            for (int i = group.begin; i < group.end; ++i)
+            {
+                paths[order[i]] = roadMap.pathTo(*group.tree, trips[order[i]].endVertex);
+            }
+            workspace.stats.stopPaths();
+            return;
+        }
+
+        std::vector<int> endVertices;
+        for (int i = group.begin; i < group.end; ++i)
+        {
+            endVertices.push_back(trips[order[i]].endVertex);
+        }
+
+        std::vector<DigraphPath> found = roadMap.findShortestPathsTo(
+            first.startVertex, endVertices, weights, workspace);
+
+        for (int i = group.begin; i < group.end; ++i)
+        {
+            paths[order[i]] = std::move(found[i - group.begin]);
+        }
+    }
+}
+
+
+TripSolver::TripSolver(const CompactRoadMap& roadMap, unsigned workers)
+    : roadMap_{roadMap}, reachability_{roadMap}, pool_{workers},
+      distanceWeights_{roadMap.weightColumn(DistanceWeight{})},
+      timeWeights_{roadMap.weightColumn(TimeWeight{})},
+      distanceBucketWidth_{averageWeight(distanceWeights_)},
+      timeBucketWidth_{averageWeight(timeWeights_)},
+      keepingStats_{false}
+{
+    workspaces_.resize(pool_.workerCount());
+}
+
+
+void TripSolver::setTreeCacheCapacity(int capacity)
+{
+    cache_.setCapacity(capacity);
+}
+
+
+void TripSolver::setKeepingStats(bool keeping)
+{
+    keepingStats_ = keeping;
+    if (keeping)
+    {
+        countingWorkspaces_.resize(pool_.workerCount());
+    }
+}
+
+
+const std::vector<SearchStats>& TripSolver::tripStats() const noexcept
+{
+    return tripStats_;
+}
+
+
+const SearchStats& TripSolver::batchStats() const noexcept
+{
+    return batchStats_;
+}
+
+
+DigraphPath TripSolver::solveTrip(const Trip& trip, DijkstraWorkspace& workspace) const
+{
+    if (unreachable(trip))
+    {
+        return DigraphPath{{}, std::numeric_limits<double>::infinity(), {}, {}};
+    }
+
+    return roadMap_.findShortestPath(trip.startVertex, trip.endVertex, weights(trip.metric), workspace);
+}
+
+
+std::vector<DigraphPath> TripSolver::solveTrips(const std::vector<Trip>& trips)
+{
+    std::vector<DigraphPath> paths(trips.size());
+
+    // Trips that can't possibly be made are answered right away; the rest
+    // are sorted (by number, so the trips themselves stay in order) into
+    // groups with the same metric and start vertex.
+    std::vector<int> order;
+    order.reserve(trips.size());
+    for (int i = 0; i < static_cast<int>(trips.size()); ++i)
+    {
+        if (unreachable(trips[i]))
+        {
+            paths[i] = DigraphPath{{}, std::numeric_limits<double>::infinity(), {}, {}};
+        }
+        else
+        {
+            order.push_back(i);
+        }
+    }
+
+    std::stable_sort(
+        order.begin(), order.end(),
+        [&trips](int a, int b)
+        {
+            return std::make_pair(trips[a].metric, trips[a].startVertex)
+                < std::make_pair(trips[b].metric, trips[b].startVertex);
+        });
+
+    std::vector<TripGroup> groups;
+    bool caching = cache_.capacity() > 0;
+    for (int begin = 0, end; begin < static_cast<int>(order.size()); begin = end)
+    {
+        const Trip& first = trips[order[begin]];
+        for (end = begin + 1; end < static_cast<int>(order.size()); ++end)
+        {
+            const Trip& trip = trips[order[end]];
+            if (trip.metric != first.metric || trip.startVertex != first.startVertex)
+            {
+                break;
+            }
+        }
+
+        std::shared_ptr<const ShortestPathTree> tree;
+        if (caching)
+        {
+            tree = cache_.find(first.startVertex, first.metric);
+        }
+        groups.push_back(TripGroup{begin, end, tree, tree == nullptr});
+    }
+
+    std::vector<SearchStats> groupStats;
+    if (keepingStats_)
+    {
+        tripStats_.assign(trips.size(), SearchStats{});
+        groupStats.resize(groups.size());
+    }
+
+    pool_.run(
+        static_cast<int>(groups.size()),
+        [&](int worker, int g)
+        {
+            TripGroup& group = groups[g];
+            const EdgeWeightColumn& groupWeights = weights(trips[order[group.begin]].metric);
+
+            if (!keepingStats_)
+            {
+                solveGroup(roadMap_, groupWeights, trips, order, group, caching, paths, workspaces_[worker]);
+                return;
+            }
+
+            CountingDijkstraWorkspace& workspace = countingWorkspaces_[worker];
+            solveGroup(roadMap_, groupWeights, trips, order, group, caching, paths, workspace);
+            groupStats[g] = workspace.stats;
+            for (int i = group.begin; i < group.end; ++i)
+            {
+                tripStats_[order[i]] = workspace.stats;
+            }
+        });
+
+    if (keepingStats_)
+    {
+        batchStats_ = SearchStats{};
+        for (const SearchStats& stats : groupStats)
+        {
+            batchStats_ += stats;
+        }
+    }
+
+    if (caching)
+    {
+        for (const TripGroup& group : groups)
+        {
+            if (group.searched)
+            {
+                const Trip& first = trips[order[group.begin]];
+                cache_.insert(first.startVertex, first.metric, group.tree);
+            }
+        }
+    }
+
+    return paths;
+}
+
+
+std::vector<ReachedVertex> TripSolver::reachableWithin(
+    int startVertex, TripMetric metric, double budget,
+    DijkstraWorkspace& workspace) const
+{
+    return roadMap_.findVerticesWithin(startVertex, budget, weights(metric), workspace);
+}
+
+
+DistanceMatrix TripSolver::distanceMatrix(
+    const std::vector<int>& sourceVertices,
+    const std::vector<int>& targetVertices,
+    TripMetric metric)
+{
+    return roadMap_.distanceMatrix(sourceVertices, targetVertices, weights(metric), pool_, workspaces_);
+}
+
+
+ShortestPathTree TripSolver::shortestPathTree(int startVertex, TripMetric metric)
+{
+    return roadMap_.findShortestPathTree(startVertex, weights(metric), bucketWidth(metric), pool_);
+}
+
+
+double TripSolver::bucketWidth(TripMetric metric) const noexcept
+{
+    return metric == TripMetric::Distance ? distanceBucketWidth_ : timeBucketWidth_;
+}
+
+
+void TripSolver::setBucketWidth(TripMetric metric, double width)
+{
+    if (metric == TripMetric::Distance)
+    {
+        distanceBucketWidth_ = width;
+    }
+    else
+    {
+        timeBucketWidth_ = width;
+    }
+}
+
+
+bool TripSolver::unreachable(const Trip& trip) const
+{
+    int startIndex = roadMap_.indexOf(trip.startVertex);
+    int endIndex = roadMap_.indexOf(trip.endVertex);
+    return reachability_.reachability(startIndex, endIndex) == Reachability::Unreachable;
+}
+
+
+const EdgeWeightColumn& TripSolver::weights(TripMetric metric) const noexcept
+{
+    return metric == TripMetric::Distance ? distanceWeights_ : timeWeights_;
+}
+
@@ -0,0 +1,164 @@
+// TripSolver.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A TripSolver finds the shortest path for each Trip in a batch of them,
+// against one CompactRoadMap.
+//
+// Trips that share a start vertex and a TripMetric (e.g., every delivery
+// leaving the same depot) are grouped together and answered by a single
+// search, which stops once every one of their end vertices is settled.
+// Optionally, the solver also keeps a ShortestPathTreeCache of recently
+// used start vertices from one batch to the next; with the cache turned
+// on, each search settles the whole graph so that its tree can answer any
+// later trip from the same start vertex without searching again.
+//
+// Groups don't depend on one another, so they're spread over the workers
+// of a WorkStealingPool, each of which keeps its own DijkstraWorkspace
+// from one search (and one batch) to the next.  The results come back in
+// the same order as the trips, so they can be reported in input order no
+// matter which worker solved which.
+//
+// Before any of that, each trip is checked against a ReachabilityIndex of
+// the map, so a trip whose end vertex plainly can't be reached from its
+// start vertex (e.g., one stranded behind a one-way street) is answered
+// with a path that wasn't found, without searching at all.
+//
+// When asked to, a TripSolver also keeps SearchStats (see SearchStats.hpp)
+// for each trip in a batch, recording how much work its search did and
+// how long it took.  Its workers then use CountingDijkstraWorkspaces; the
+// DijkstraWorkspaces they use otherwise keep no stats at all, so trips
+// solved without stats cost nothing extra.
+//
+// The weight of every road segment under each TripMetric is worked out
+// once, when the solver is made, into an EdgeWeightColumn that every
+// search looks weights up in.
+//
+// A TripSolver can also fill in a whole DistanceMatrix (e.g., from every
+// depot to every customer), for which the same workers each search from
+// one source at a time.
+//
+// For a query that needs the distance to every vertex (e.g., what a depot
+// can reach within an hour), a TripSolver can build a single shortest path
+// tree with all of its workers at once, by delta-stepping.  How wide the
+// buckets are can be tuned for each TripMetric, since the weights under
+// each are on different scales.
+
+#ifndef TRIPSOLVER_HPP
+#define TRIPSOLVER_HPP
+
+#include <vector>
+#include "DijkstraWorkspace.hpp"
+#include "DistanceMatrix.hpp"
+#include "EdgeWeightColumn.hpp"
+#include "ReachabilityIndex.hpp"
+#include "RoadMap.hpp"
+#include "SearchStats.hpp"
+#include "ShortestPathTree.hpp"
+#include "ShortestPathTreeCache.hpp"
+#include "Trip.hpp"
+#include "TripMetric.hpp"
+#include "WorkStealingPool.hpp"
+
+
+
+class TripSolver
+{
+public:
+    // Initializes a TripSolver for the given map, which must outlive it,
+    // using the given number of worker threads (0 means one per hardware
+    // thread).  The tree cache starts out turned off.
+    explicit TripSolver(const CompactRoadMap& roadMap, unsigned workers = 0);
+
+    // setTreeCacheCapacity() sets the number of shortest path trees kept
+    // from one batch to the next; 0 turns the cache off.
+    void setTreeCacheCapacity(int capacity);
+
+    // setKeepingStats() turns the keeping of stats for each trip on or
+    // off; it starts out off.
+    void setKeepingStats(bool keeping);
+
+    // tripStats() returns the stats of each trip in the last batch given
+    // to solveTrips() while stats were being kept, in the same order as
+    // the trips.  Trips answered by the same search (see above) share its
+    // stats; a trip that needed no search at all has no counts, only the
+    // time taken to reconstruct its path.
+    const std::vector<SearchStats>& tripStats() const noexcept;
+
+    // batchStats() returns the stats of that whole batch, which are those
+    // of its searches added together (each counted once, however many
+    // trips it answered).
+    const SearchStats& batchStats() const noexcept;
+
+    // solveTrip() returns the shortest path for one trip, under the trip's
+    // metric, using the given workspace as scratch space.  If either of
+    // the trip's vertices does not exist, a DigraphException is thrown.
+    // If there's no path, the result's found() returns false.
+    DigraphPath solveTrip(const Trip& trip, DijkstraWorkspace& workspace) const;
+
+    // solveTrips() returns the shortest path for each of the given trips,
+    // in the same order as the trips.  If any trip names a vertex that
+    // does not exist, a DigraphException is thrown.
+    std::vector<DigraphPath> solveTrips(const std::vector<Trip>& trips);
+
+    // reachableWithin() returns every vertex that can be reached from the
+    // given start vertex within the given budget under the given metric
+    // (e.g., within 0.25 hours), with its cost, in order of cost, using the
+    // given workspace as scratch space.  Only the part of the map within
+    // the budget is searched.  If the start vertex does not exist, a
+    // DigraphException is thrown.
+    std::vector<ReachedVertex> reachableWithin(
+        int startVertex, TripMetric metric, double budget,
+        DijkstraWorkspace& workspace) const;
+
+    // distanceMatrix() returns the cost of a shortest path from each of the
+    // given source vertices (the rows) to each of the given target vertices
+    // (the columns) under the given metric, with one search per source
+    // spread over the solver's workers.  If any of the vertices does not
+    // exist, a DigraphException is thrown.
+    DistanceMatrix distanceMatrix(
+        const std::vector<int>& sourceVertices,
+        const std::vector<int>& targetVertices,
+        TripMetric metric);
+
+    // shortestPathTree() settles the whole map from the given start vertex
+    // under the given metric, spreading one delta-stepping search over the
+    // solver's workers, and returns the tree, which is the same one a
+    // single-threaded search would have built.  If the start vertex does
+    // not exist, a DigraphException is thrown.
+    ShortestPathTree shortestPathTree(int startVertex, TripMetric metric);
+
+    // bucketWidth() returns the bucket width that shortestPathTree() uses
+    // under the given metric, which starts out as the average weight of a
+    // road segment under it, and setBucketWidth() changes it.  The width
+    // must be positive.
+    double bucketWidth(TripMetric metric) const noexcept;
+    void setBucketWidth(TripMetric metric, double width);
+
+private:
+    const CompactRoadMap& roadMap_;
+    ReachabilityIndex reachability_;
+    WorkStealingPool pool_;
+    EdgeWeightColumn distanceWeights_;
+    EdgeWeightColumn timeWeights_;
+    double distanceBucketWidth_;
+    double timeBucketWidth_;
+    std::vector<DijkstraWorkspace> workspaces_;
+    std::vector<CountingDijkstraWorkspace> countingWorkspaces_;
+    ShortestPathTreeCache cache_;
+    bool keepingStats_;
+    std::vector<SearchStats> tripStats_;
+    SearchStats batchStats_;
+
+    //returns true if the index shows the trip can't be made
+    bool unreachable(const Trip& trip) const;
+
+    //returns the weights of the road segments under the given metric
+    const EdgeWeightColumn& weights(TripMetric metric) const noexcept;
+};
+
+
+
+#endif // TRIPSOLVER_HPP
+
@@ -0,0 +1,178 @@
+// VertexIndex.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A VertexIndex maps vertex numbers to dense indices (i.e., positions in
+// some std::vector) in constant time.  Vertex numbers in a Digraph are not
+// necessarily sequential, but in practice they usually are (a RoadMapReader
+// numbers its locations 0, 1, 2, ...), so a VertexIndex keeps the mapping in
+// a plain array indexed by vertex number for as long as the numbers stay
+// reasonably dense, and only falls back to a hash table when they don't.
+
+#ifndef VERTEXINDEX_HPP
+#define VERTEXINDEX_HPP
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+
+
+class VertexIndex
+{
+public:
+    // The default constructor initializes an empty VertexIndex.
+    VertexIndex();
+
+    // find() returns the index associated with the given vertex number,
+    // or -1 if there isn't one.
+    int find(int vertex) const noexcept;
+
+    // insert() associates the given index with the given vertex number,
+    // replacing any index that was associated with it before.
+    void insert(int vertex, int index);
+
+    // erase() removes the association for the given vertex number, if
+    // there is one.
+    void erase(int vertex);
+
+    // clear() removes every association.
+    void clear() noexcept;
+
+    // size() returns the number of vertex numbers with an index.
+    int size() const noexcept;
+
+private:
+    // While direct is true, slots[vertex - base] holds the index of each
+    // vertex (or -1); otherwise the indices live in hashed.
+    bool direct;
+    long long base;
+    std::vector<int> slots;
+    std::unordered_map<int, int> hashed;
+    int count;
+
+    // the array form is abandoned once it would be more than this many
+    // times larger than the number of vertices it holds
+    static constexpr long long maxSparseness = 4;
+};
+
+
+
+inline VertexIndex::VertexIndex()
+    : direct{true}, base{0}, count{0}
+{
+}
+
+
+inline int VertexIndex::find(int vertex) const noexcept
+{
+    if(direct)
+    {
+        long long slot = vertex - base;
+        if(slot < 0 || slot >= static_cast<long long>(slots.size()))
+        {
+            return -1;
+        }
+        return slots[slot];
+    }
+
+    auto i = hashed.find(vertex);
+    return i == hashed.end() ? -1 : i->second;
+}
+
+
+inline void VertexIndex::insert(int vertex, int index)
+{
+    if(direct)
+    {
+        if(slots.empty())
+        {
+            base = vertex;
+        }
+
+        long long low = std::min<long long>(base, vertex);
+        long long high = std::max<long long>(base + slots.size(), vertex + 1LL);
+        if(high - low <= maxSparseness * (count + 1) + 64)
+        {
+            if(vertex < base)
+            {
+                // Leave some room below the new lowest vertex number, so
+                // that numbers arriving in decreasing order don't shift
+                // the array over and over.
+                long long headroom = std::min<long long>(slots.size(), vertex - (-2147483647LL - 1));
+                long long shift = base - vertex + headroom;
+                slots.insert(slots.begin(), shift, -1);
+                base -= shift;
+            }
+            else if(vertex - base >= static_cast<long long>(slots.size()))
+            {
+                slots.resize(vertex - base + 1, -1);
+            }
+
+            int& slot = slots[vertex - base];
+            if(slot == -1)
+            {
+                count++;
+            }
+            slot = index;
+            return;
+        }
+
+        hashed.reserve(count + 1);
+        for(long long i = 0; i < static_cast<long long>(slots.size()); i++)
+        {
+            if(slots[i] != -1)
+            {
+                hashed[static_cast<int>(base + i)] = slots[i];
+            }
+        }
+        slots.clear();
+        slots.shrink_to_fit();
+        direct = false;
+    }
+
+    if(hashed.insert_or_assign(vertex, index).second)
+    {
+        count++;
+    }
+}
+
+
+inline void VertexIndex::erase(int vertex)
+{
+    if(direct)
+    {
+        long long slot = vertex - base;
+        if(slot >= 0 && slot < static_cast<long long>(slots.size()) && slots[slot] != -1)
+        {
+            slots[slot] = -1;
+            count--;
+        }
+    }
+    else if(hashed.erase(vertex) != 0)
+    {
+        count--;
+    }
+}
+
+
+inline void VertexIndex::clear() noexcept
+{
+    direct = true;
+    base = 0;
+    slots.clear();
+    hashed.clear();
+    count = 0;
+}
+
+
+inline int VertexIndex::size() const noexcept
+{
+    return count;
+}
+
+
+
+#endif // VERTEXINDEX_HPP
+
@@ -0,0 +1,364 @@
+// VertexOrder.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This header file declares function templates that choose an order for
+// the vertices of a CompactDigraph, each returning it as a std::vector in
+// which order[r] is the index of the vertex that comes r-th (its "rank").
+// CompactDigraph::renumbered() lays a graph out again in such an order,
+// so that vertices that are near each other in the graph are also near
+// each other in memory, and a search that moves from a vertex to its
+// neighbors keeps finding them in the cache.  A road map read in the
+// order its locations were listed has no such locality.
+//
+// * cuthillMcKeeOrder() numbers the vertices breadth-first, so each
+//   vertex's neighbors are all numbered close to it.
+// * nestedDissectionOrder() cuts the graph in two with a small separator,
+//   orders each half the same way, and puts the separator after both, so
+//   every part of the graph (at every scale) is one contiguous range.
+//   It's also the order a CustomizableContractionHierarchy contracts its
+//   vertices in.
+//
+// (RoadMapGeometry.hpp adds a third, hilbertCurveOrder(), for road maps
+// whose locations are known.)
+//
+// Both ignore the directions of the edges and take O((V + E) log V) time
+// at most.
+
+#ifndef VERTEXORDER_HPP
+#define VERTEXORDER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "CompactDigraph.hpp"
+
+
+
+// findNeighbors() returns the neighbors of each index of the given graph,
+// in either direction, in CSR form: the neighbors of index i are at
+// positions [offsets[i], offsets[i + 1]) of the second vector, where
+// offsets is the first.  A neighbor joined by edges in both directions
+// appears twice.
+
+template <typename VertexInfo, typename EdgeInfo>
+std::pair<std::vector<int>, std::vector<int>> findNeighbors(const CompactDigraph<VertexInfo, EdgeInfo>& graph);
+
+
+// cuthillMcKeeOrder() returns the Cuthill-McKee order of the given graph:
+// each connected part is searched breadth-first from one of its vertices
+// of the lowest degree, visiting the unvisited neighbors of each vertex in
+// increasing order of their degrees.  Parts are ordered by that starting
+// vertex's degree, then its index.
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<int> cuthillMcKeeOrder(const CompactDigraph<VertexInfo, EdgeInfo>& graph);
+
+
+// nestedDissectionOrder() returns a nested dissection order of the given
+// graph, cutting it into parts of at most leafSize vertices, which keep
+// the order in which breadth-first searches reached them.
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<int> nestedDissectionOrder(const CompactDigraph<VertexInfo, EdgeInfo>& graph, int leafSize = 32);
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::pair<std::vector<int>, std::vector<int>> findNeighbors(const CompactDigraph<VertexInfo, EdgeInfo>& graph)
+{
+    int n = graph.vertexCount();
+    std::vector<int> neighborOffsets(n + 1, 0);
+    for(int from = 0; from < n; from++)
+    {
+        neighborOffsets[from + 1] += graph.edgeEnd(from) - graph.edgeBegin(from);
+        neighborOffsets[from + 1] += graph.reverseEdgeEnd(from) - graph.reverseEdgeBegin(from);
+    }
+    for(int i = 0; i < n; i++)
+    {
+        neighborOffsets[i + 1] += neighborOffsets[i];
+    }
+    std::vector<int> neighbors(neighborOffsets[n]);
+    for(int from = 0; from < n; from++)
+    {
+        int next = neighborOffsets[from];
+        for(int edge = graph.edgeBegin(from); edge < graph.edgeEnd(from); edge++)
+        {
+            neighbors[next++] = graph.edgeTarget(edge);
+        }
+        for(int edge = graph.reverseEdgeBegin(from); edge < graph.reverseEdgeEnd(from); edge++)
+        {
+            neighbors[next++] = graph.reverseEdgeSource(edge);
+        }
+    }
+    return std::make_pair(std::move(neighborOffsets), std::move(neighbors));
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<int> cuthillMcKeeOrder(const CompactDigraph<VertexInfo, EdgeInfo>& graph)
+{
+    int n = graph.vertexCount();
+    std::pair<std::vector<int>, std::vector<int>> adjacency = findNeighbors(graph);
+    const std::vector<int>& neighborOffsets = adjacency.first;
+    std::vector<int>& neighbors = adjacency.second;
+
+    // Each index's neighbors are sorted by degree once, up front, so that
+    // the search only has to walk through them.
+    auto degree =
+        [&neighborOffsets](int i)
+        {
+            return neighborOffsets[i + 1] - neighborOffsets[i];
+        };
+    auto byDegree =
+        [&degree](int a, int b)
+        {
+            return degree(a) < degree(b) || (degree(a) == degree(b) && a < b);
+        };
+    for(int i = 0; i < n; i++)
+    {
+        std::sort(neighbors.begin() + neighborOffsets[i], neighbors.begin() + neighborOffsets[i + 1], byDegree);
+    }
+
+    std::vector<int> starts(n);
+    for(int i = 0; i < n; i++)
+    {
+        starts[i] = i;
+    }
+    std::sort(starts.begin(), starts.end(), byDegree);
+
+    // The order doubles as the queue of the breadth-first searches.
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+    for(int start: starts)
+    {
+        if(visited[start])
+        {
+            continue;
+        }
+
+        visited[start] = true;
+        order.push_back(start);
+        for(std::size_t i = order.size() - 1; i < order.size(); i++)
+        {
+            int u = order[i];
+            for(int j = neighborOffsets[u]; j < neighborOffsets[u + 1]; j++)
+            {
+                int w = neighbors[j];
+                if(!visited[w])
+                {
+                    visited[w] = true;
+                    order.push_back(w);
+                }
+            }
+        }
+    }
+
+    return order;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<int> nestedDissectionOrder(const CompactDigraph<VertexInfo, EdgeInfo>& graph, int leafSize)
+{
+    int n = graph.vertexCount();
+
+    std::pair<std::vector<int>, std::vector<int>> adjacency = findNeighbors(graph);
+    const std::vector<int>& neighborOffsets = adjacency.first;
+    const std::vector<int>& neighbors = adjacency.second;
+
+    // Each Part is a set of indices that are to be given the ranks
+    // [first, first + size); part[i] identifies the one that index i is in
+    // at the moment, and level[i] is scratch space for breadth-first
+    // searches within a part.
+    struct Part
+    {
+        std::vector<int> indices;
+        int first;
+    };
+
+    std::vector<int> order(n, -1);
+    std::vector<int> part(n, 0);
+    std::vector<int> level(n, -1);
+    int parts = 1;
+
+    std::vector<int> all(n);
+    for(int i = 0; i < n; i++)
+    {
+        all[i] = i;
+    }
+    std::vector<Part> pending;
+    pending.push_back(Part{std::move(all), 0});
+
+    // A breadth-first search within a part, starting from one index, which
+    // returns the indices it reaches in the order it reaches them, leaving
+    // the level of each one in the same position of depths.
+    std::vector<int> depths;
+    auto search =
+        [&](int start, int id)
+        {
+            std::vector<int> reached{start};
+            level[start] = 0;
+            for(std::size_t i = 0; i < reached.size(); i++)
+            {
+                int u = reached[i];
+                for(int j = neighborOffsets[u]; j < neighborOffsets[u + 1]; j++)
+                {
+                    int w = neighbors[j];
+                    if(part[w] == id && level[w] == -1)
+                    {
+                        level[w] = level[u] + 1;
+                        reached.push_back(w);
+                    }
+                }
+            }
+            depths.clear();
+            for(int u: reached)
+            {
+                depths.push_back(level[u]);
+                level[u] = -1;
+            }
+            return reached;
+        };
+
+    while(!pending.empty())
+    {
+        Part p = std::move(pending.back());
+        pending.pop_back();
+        int size = static_cast<int>(p.indices.size());
+        int id = part[p.indices[0]];
+
+        if(size <= leafSize)
+        {
+            for(int i = 0; i < size; i++)
+            {
+                order[p.first + i] = p.indices[i];
+            }
+            continue;
+        }
+
+        // Searching again from the last index reached finds many levels,
+        // each of them cutting across the part.  If the part isn't
+        // connected, the search reaches only some of it, and the part falls
+        // apart into those indices and the rest without any separator.
+        std::vector<int> reached = search(p.indices[0], id);
+        reached = search(reached.back(), id);
+
+        std::vector<int> first;
+        std::vector<int> second;
+        std::vector<int> separator;
+        int firstId = parts++;
+        int secondId = parts++;
+
+        if(static_cast<int>(reached.size()) < size)
+        {
+            for(int i: reached)
+            {
+                part[i] = firstId;
+            }
+            for(int i: p.indices)
+            {
+                if(part[i] == firstId)
+                {
+                    first.push_back(i);
+                }
+                else
+                {
+                    part[i] = secondId;
+                    second.push_back(i);
+                }
+            }
+        }
+        else
+        {
+            // Every neighbor of an index is at the level before it, the same
+            // level, or the level after it, so any level but the first and
+            // last separates the indices before it from those after it.  The
+            // one chosen has the fewest indices for the size of the smaller
+            // side, which favors small separators that split evenly.
+            int levels = depths.back() + 1;
+            std::vector<int> levelStarts(levels + 1, 0);
+            for(int depth: depths)
+            {
+                levelStarts[depth + 1]++;
+            }
+            for(int i = 0; i < levels; i++)
+            {
+                levelStarts[i + 1] += levelStarts[i];
+            }
+
+            int cut = -1;
+            double bestRatio = 0;
+            for(int i = 1; i + 1 < levels; i++)
+            {
+                int smaller = std::min(levelStarts[i], size - levelStarts[i + 1]);
+                double ratio = static_cast<double>(levelStarts[i + 1] - levelStarts[i]) / smaller;
+                if(cut == -1 || ratio < bestRatio)
+                {
+                    cut = i;
+                    bestRatio = ratio;
+                }
+            }
+
+            // A part with fewer than three levels (e.g., one in which every
+            // index is adjacent to every other) is instead cut at the middle
+            // of the search, separated by those indices of the first half
+            // that have a neighbor in the second.
+            int half = cut != -1 ? levelStarts[cut] : (size + 1) / 2;
+            int rest = cut != -1 ? levelStarts[cut + 1] : half;
+            for(int i = 0; i < size; i++)
+            {
+                part[reached[i]] = i < half ? firstId : (i < rest ? -1 : secondId);
+            }
+            separator.assign(reached.begin() + half, reached.begin() + rest);
+            for(int i = 0; i < half; i++)
+            {
+                int u = reached[i];
+                bool boundary = false;
+                for(int j = neighborOffsets[u]; j < neighborOffsets[u + 1] && !boundary; j++)
+                {
+                    boundary = part[neighbors[j]] == secondId;
+                }
+                if(boundary)
+                {
+                    separator.push_back(u);
+                }
+                else
+                {
+                    first.push_back(u);
+                }
+            }
+            for(int u: separator)
+            {
+                part[u] = -1;
+            }
+            second.assign(reached.begin() + rest, reached.end());
+        }
+
+        // The separator is ranked above both parts.
+        int next = p.first + static_cast<int>(first.size() + second.size());
+        for(int u: separator)
+        {
+            order[next++] = u;
+        }
+
+        int secondFirst = p.first + static_cast<int>(first.size());
+        if(!first.empty())
+        {
+            pending.push_back(Part{std::move(first), p.first});
+        }
+        if(!second.empty())
+        {
+            pending.push_back(Part{std::move(second), secondFirst});
+        }
+    }
+
+    return order;
+}
+
+
+
+#endif // VERTEXORDER_HPP
@@ -0,0 +1,187 @@
+// WorkStealingPool.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include "WorkStealingPool.hpp"
+
+
+WorkStealingPool::WorkStealingPool(unsigned workers)
+    : generation{0}, running{0}, stopping{false}, current{nullptr}
+{
+    if (workers == 0)
+    {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned i = 0; i < workers; ++i)
+    {
+        ranges.push_back(std::make_unique<Range>());
+    }
+
+    for (unsigned i = 1; i < workers; ++i)
+    {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, static_cast<int>(i));
+    }
+}
+
+
+WorkStealingPool::~WorkStealingPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    started.notify_all();
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+
+int WorkStealingPool::workerCount() const noexcept
+{
+    return static_cast<int>(ranges.size());
+}
+
+
+void WorkStealingPool::run(int taskCount, const std::function<void(int, int)>& task)
+{
+    int workers = workerCount();
+
+    for (int i = 0; i < workers; ++i)
+    {
+        std::lock_guard<std::mutex> lock{ranges[i]->mutex};
+        ranges[i]->begin = static_cast<int>(static_cast<long long>(taskCount) * i / workers);
+        ranges[i]->end = static_cast<int>(static_cast<long long>(taskCount) * (i + 1) / workers);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        current = &task;
+        failure = nullptr;
+        running = workers - 1;
+        ++generation;
+    }
+    started.notify_all();
+
+    work(0);
+
+    std::exception_ptr thrown;
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        finished.wait(lock, [this] { return running == 0; });
+        current = nullptr;
+        thrown = failure;
+        failure = nullptr;
+    }
+
+    if (thrown)
+    {
+        std::rethrow_exception(thrown);
+    }
+}
+
+
+void WorkStealingPool::workerLoop(int worker)
+{
+    int seen = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            started.wait(lock, [this, seen] { return stopping || generation != seen; });
+
+            if (stopping)
+            {
+                return;
+            }
+
+            seen = generation;
+        }
+
+        work(worker);
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            --running;
+        }
+        finished.notify_one();
+    }
+}
+
+
+void WorkStealingPool::work(int worker)
+{
+    const std::function<void(int, int)>& task = *current;
+
+    for (int i = take(worker); i != -1; i = take(worker))
+    {
+        try
+        {
+            task(worker, i);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+
+            if (!failure)
+            {
+                failure = std::current_exception();
+            }
+
+            // Drop every task that hasn't started yet.
+            for (std::unique_ptr<Range>& range : ranges)
+            {
+                std::lock_guard<std::mutex> rangeLock{range->mutex};
+                range->end = range->begin;
+            }
+        }
+    }
+}
+
+
+int WorkStealingPool::take(int worker)
+{
+    {
+        Range& own = *ranges[worker];
+        std::lock_guard<std::mutex> lock{own.mutex};
+
+        if (own.begin < own.end)
+        {
+            return own.begin++;
+        }
+    }
+
+    // Our own range is empty, so look for another worker's to steal from,
+    // taking the back half of it: the owner keeps working from the front,
+    // so the two of us rarely contend for the same lock.  Both ranges stay
+    // locked while the stolen half moves between them, so a failed task
+    // that drops every waiting task can't miss the half in transit.
+    int workers = workerCount();
+    Range& own = *ranges[worker];
+
+    for (int offset = 1; offset < workers; ++offset)
+    {
+        Range& victim = *ranges[(worker + offset) % workers];
+        std::scoped_lock lock{own.mutex, victim.mutex};
+
+        if (victim.begin >= victim.end)
+        {
+            continue;
+        }
+
+        int begin = victim.end - (victim.end - victim.begin + 1) / 2;
+        own.begin = begin + 1;
+        own.end = victim.end;
+        victim.end = begin;
+        return begin;
+    }
+
+    return -1;
+}
+
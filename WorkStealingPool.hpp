@@ -0,0 +1,91 @@
+// WorkStealingPool.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A WorkStealingPool is a fixed set of worker threads that run batches of
+// independent, numbered tasks (e.g., one task per Trip).  Each batch is
+// split evenly into one range of task numbers per worker; a worker takes
+// tasks from the front of its own range, and a worker whose range runs out
+// steals the back half of the range of some other worker that still has
+// tasks left.  That way, a worker that happens to draw a run of expensive
+// tasks doesn't hold up the whole batch.
+//
+// The thread that calls run() takes part as worker 0, so a pool of one
+// worker starts no threads at all.
+
+#ifndef WORKSTEALINGPOOL_HPP
+#define WORKSTEALINGPOOL_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+class WorkStealingPool
+{
+public:
+    // Initializes a WorkStealingPool with the given number of workers; 0
+    // means one per hardware thread.
+    explicit WorkStealingPool(unsigned workers = 0);
+
+    // The destructor waits for the worker threads to finish.
+    ~WorkStealingPool() noexcept;
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // workerCount() returns the number of workers, including the thread
+    // that calls run().
+    int workerCount() const noexcept;
+
+    // run() calls task(worker, i) once for every i in [0, taskCount),
+    // where worker is the number (in [0, workerCount())) of the worker
+    // making the call, and returns once every call has returned.  Calls
+    // made by the same worker never overlap, so a task can freely use
+    // scratch space set aside for its worker.  If any call throws, the
+    // tasks not yet started are skipped and the first exception thrown
+    // is rethrown by run().
+    void run(int taskCount, const std::function<void(int, int)>& task);
+
+private:
+    // A Range is the tasks [begin, end) still waiting for a worker.
+    struct Range
+    {
+        std::mutex mutex;
+        int begin;
+        int end;
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<Range>> ranges;
+
+    // guards everything below; a new batch bumps generation
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+    int generation;
+    int running;
+    bool stopping;
+    const std::function<void(int, int)>* current;
+    std::exception_ptr failure;
+
+    //the loop run by each worker thread
+    void workerLoop(int worker);
+
+    //runs tasks as the given worker until no worker has any left
+    void work(int worker);
+
+    //takes the next task for the given worker, or returns -1
+    int take(int worker);
+};
+
+
+
+#endif // WORKSTEALINGPOOL_HPP
+
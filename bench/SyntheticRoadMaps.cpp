@@ -0,0 +1,138 @@
+// SyntheticRoadMaps.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <utility>
+#include <vector>
+#include "SyntheticRoadMaps.hpp"
+
+
+namespace
+{
+    // Locations are spread around this corner of the map, this many
+    // degrees apart on a grid (about two thirds of a mile).
+    const double baseLatitude = 33.6;
+    const double baseLongitude = -117.9;
+    const double spacingDegrees = 0.01;
+
+    const double speedLimits[] = {25.0, 35.0, 45.0, 65.0};
+
+
+    // Writes the locations, then the segments (each as a pair of vertex
+    // numbers, both ways), in RoadMapReader's format.  A segment is 1% to
+    // 30% longer than the straight line, so the great-circle heuristic
+    // stays a lower bound even after the miles are rounded for printing.
+    std::string writeRoadMap(
+        int locations, const std::vector<std::pair<int, int>>& roads,
+        const RoadMapGeometry& geometry, std::mt19937& random)
+    {
+        std::uniform_real_distribution<double> detour{1.01, 1.3};
+        std::uniform_int_distribution<int> speed{0, 3};
+
+        std::ostringstream out;
+        out << std::setprecision(10);
+        out << locations << '\n';
+        for (int i = 0; i < locations; ++i)
+        {
+            out << "Place " << i << '\n';
+        }
+
+        out << roads.size() * 2 << '\n';
+        for (const std::pair<int, int>& road : roads)
+        {
+            double miles = geometry.milesBetween(road.first, road.second) * detour(random) + 0.01;
+            double milesPerHour = speedLimits[speed(random)];
+            out << road.first << ' ' << road.second << ' ' << miles << ' ' << milesPerHour << '\n';
+            out << road.second << ' ' << road.first << ' ' << miles << ' ' << milesPerHour << '\n';
+        }
+        return out.str();
+    }
+}
+
+
+SyntheticRoadMap makeGridRoadMap(int rows, int columns, unsigned seed)
+{
+    std::mt19937 random{seed};
+    SyntheticRoadMap roadMap;
+
+    std::vector<std::pair<int, int>> roads;
+    for (int r = 0; r < rows; ++r)
+    {
+        for (int c = 0; c < columns; ++c)
+        {
+            int vertex = r * columns + c;
+            roadMap.geometry.setLocation(
+                vertex, baseLatitude + r * spacingDegrees, baseLongitude + c * spacingDegrees);
+            if (c + 1 < columns)
+            {
+                roads.push_back(std::make_pair(vertex, vertex + 1));
+            }
+            if (r + 1 < rows)
+            {
+                roads.push_back(std::make_pair(vertex, vertex + columns));
+            }
+        }
+    }
+
+    roadMap.text = writeRoadMap(rows * columns, roads, roadMap.geometry, random);
+    return roadMap;
+}
+
+
+SyntheticRoadMap makeScaleFreeRoadMap(int locations, int roadsPerLocation, unsigned seed)
+{
+    std::mt19937 random{seed};
+    SyntheticRoadMap roadMap;
+
+    double side = std::sqrt(static_cast<double>(locations)) * spacingDegrees;
+    std::uniform_real_distribution<double> offset{0.0, side};
+    for (int i = 0; i < locations; ++i)
+    {
+        roadMap.geometry.setLocation(i, baseLatitude + offset(random), baseLongitude + offset(random));
+    }
+
+    // Every road adds both of its ends to ends, so picking a uniformly
+    // random entry of it picks a location with probability proportional to
+    // the number of roads it has.  The first few locations are joined in a
+    // line to get started.
+    std::vector<std::pair<int, int>> roads;
+    std::vector<int> ends;
+    int seeds = std::min(locations, roadsPerLocation + 1);
+    for (int i = 1; i < seeds; ++i)
+    {
+        roads.push_back(std::make_pair(i - 1, i));
+        ends.push_back(i - 1);
+        ends.push_back(i);
+    }
+
+    std::vector<int> chosen;
+    for (int i = seeds; i < locations; ++i)
+    {
+        chosen.clear();
+        while (static_cast<int>(chosen.size()) < std::min(roadsPerLocation, i))
+        {
+            int other = ends[std::uniform_int_distribution<std::size_t>{0, ends.size() - 1}(random)];
+            if (std::find(chosen.begin(), chosen.end(), other) == chosen.end())
+            {
+                chosen.push_back(other);
+            }
+        }
+        for (int other : chosen)
+        {
+            roads.push_back(std::make_pair(other, i));
+            ends.push_back(other);
+            ends.push_back(i);
+        }
+    }
+
+    roadMap.text = writeRoadMap(locations, roads, roadMap.geometry, random);
+    return roadMap;
+}
+
@@ -0,0 +1,54 @@
+// SyntheticRoadMaps.hpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This header file declares the functions the benchmark uses to make up
+// road maps of any size.  Each writes the map in the same text format that
+// RoadMapReader reads, so that loading one is measured the same way as
+// loading a real one.  It also gives every location a made-up latitude and
+// longitude, so A* has a heuristic to work with.
+//
+// * A grid map is a city street grid: each location has a road to and
+//   from each of its (up to) four neighbors.
+// * A scale-free map is grown by preferential attachment: each new
+//   location is joined to a few older ones, chosen with probability
+//   proportional to how many roads they already have.  A few hubs end up
+//   with most of the roads, the way highway interchanges do.
+//
+// Every segment is a little longer than the straight line between its
+// ends, and its speed is one of a few typical speed limits.  The same seed
+// always makes the same map.
+
+#ifndef SYNTHETICROADMAPS_HPP
+#define SYNTHETICROADMAPS_HPP
+
+#include <string>
+#include "RoadMapGeometry.hpp"
+
+
+
+struct SyntheticRoadMap
+{
+    std::string text;
+    RoadMapGeometry geometry;
+};
+
+
+
+// makeGridRoadMap() returns a grid map with the given number of rows and
+// columns of locations.
+
+SyntheticRoadMap makeGridRoadMap(int rows, int columns, unsigned seed);
+
+
+
+// makeScaleFreeRoadMap() returns a scale-free map with the given number of
+// locations, each new one joined (both ways) to the given number of older
+// ones.
+
+SyntheticRoadMap makeScaleFreeRoadMap(int locations, int roadsPerLocation, unsigned seed);
+
+
+
+#endif // SYNTHETICROADMAPS_HPP
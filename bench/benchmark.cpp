@@ -0,0 +1,471 @@
+// benchmark.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This is the main() function of the benchmark, which measures how fast
+// the program loads road maps and answers trips against them, on maps it
+// makes up (see SyntheticRoadMaps.hpp) or on a real one.  For each map it
+// reports:
+//
+// * the time to read the map through RoadMapReader, and to lay it out as a
+//   CompactRoadMap, along with how much memory each took
+// * the time to find the strongly connected components of each of those
+// * the latency (50th, 90th and 99th percentiles, and the worst) of single
+//   trips answered by each search engine: Dijkstra's algorithm on the
+//   RoadMap, and on the CompactRoadMap; the bidirectional search; A* (with
+//   the great-circle heuristic, where there's geometry); and the
+//   contraction hierarchy, whose preprocessing time is reported, too
+// * the throughput of a TripSolver answering a whole batch of trips
+//
+// Every engine answers the same trips, and each cost it finds is checked
+// against the one Dijkstra's algorithm finds on the CompactRoadMap.  If any
+// of them differs, the benchmark says so and exits with status 1, so it can
+// stand guard over a change that's supposed to make things faster without
+// changing what they find.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "InputReader.hpp"
+#include "InputScanner.hpp"
+#include "RoadMapGeometry.hpp"
+#include "RoadMapGeometryReader.hpp"
+#include "RoadMapHierarchies.hpp"
+#include "RoadMapReader.hpp"
+#include "SyntheticRoadMaps.hpp"
+#include "TripSolver.hpp"
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+
+    //returns the time since the given one, in milliseconds
+    double millisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+
+    //returns the memory the process has resident, in megabytes, or 0 where
+    //that can't be found out (it's read from /proc, so only on Linux)
+    double residentMegabytes()
+    {
+        std::ifstream status{"/proc/self/status"};
+        std::string line;
+        while (std::getline(status, line))
+        {
+            if (line.compare(0, 6, "VmRSS:") == 0)
+            {
+                return std::stod(line.substr(6)) / 1024.0;
+            }
+        }
+        return 0.0;
+    }
+
+
+    //returns true if two costs are the same, to within rounding (a
+    //hierarchy adds up a path's weights in a different order)
+    bool sameCost(double a, double b)
+    {
+        if (std::isinf(a) || std::isinf(b))
+        {
+            return a == b;
+        }
+        return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(a));
+    }
+
+
+    // A Workload is a map to run the benchmark on, before it's been read:
+    // its text, in RoadMapReader's format, or the file it's in.  Its
+    // geometry, if it has one, is what A* steers by.
+    struct Workload
+    {
+        std::string name;
+        std::string text;
+        std::string file;
+        std::shared_ptr<RoadMapGeometry> geometry;
+    };
+
+
+    struct Options
+    {
+        std::vector<int> sizes{1000, 10000};
+        std::vector<std::string> engines{"roadmap", "bidirectional", "astar", "hierarchy"};
+        std::string mapFile;
+        std::string geometryFile;
+        int queries = 100;
+        int trips = 5000;
+        unsigned workers = 0;
+        unsigned seed = 1;
+    };
+
+
+    //runs Dijkstra's algorithm on the compact map, then each of the given
+    //engines, on the same trips and reports their latencies, returning the
+    //number of costs that didn't match
+    int runEngines(
+        const RoadMap& roadMap, const CompactRoadMap& compact,
+        const RoadMapGeometry* geometry, const std::vector<Trip>& trips,
+        const std::vector<std::string>& selected)
+    {
+        auto isSelected =
+            [&selected](const std::string& key)
+            {
+                return std::find(selected.begin(), selected.end(), key) != selected.end();
+            };
+
+        // The hierarchy takes far longer to build than anything else, so it's
+        // only built if it's going to be used.
+        std::unique_ptr<RoadMapHierarchy> hierarchy;
+        Clock::time_point start = Clock::now();
+        if (isSelected("hierarchy"))
+        {
+            hierarchy = std::make_unique<RoadMapHierarchy>(compact, DistanceWeight{});
+            std::cout << "  contraction hierarchy: " << millisecondsSince(start) << " ms to build" << '\n';
+        }
+
+        DijkstraWorkspace forward;
+        DijkstraWorkspace backward;
+        double fastest = maxMilesPerHour(compact);
+
+        struct Engine
+        {
+            std::string key;
+            std::string name;
+            std::function<double(const Trip&)> cost;
+        };
+
+        std::vector<Engine> engines{
+            {"dijkstra", "dijkstra (compact)",
+             [&](const Trip& trip)
+             {
+                 return compact.findShortestPath(
+                     trip.startVertex, trip.endVertex, DistanceWeight{}, forward).cost;
+             }},
+            {"roadmap", "dijkstra (roadmap)",
+             [&](const Trip& trip)
+             {
+                 std::map<int, int> predecessors = roadMap.findShortestPaths(
+                     trip.startVertex,
+                     [](const RoadSegment& segment)
+                     {
+                         return segment.miles;
+                     });
+                 double cost = 0.0;
+                 for (int vertex = trip.endVertex; vertex != trip.startVertex; )
+                 {
+                     int previous = predecessors[vertex];
+                     if (previous == vertex)
+                     {
+                         return std::numeric_limits<double>::infinity();
+                     }
+                     cost += roadMap.edgeInfo(previous, vertex).miles;
+                     vertex = previous;
+                 }
+                 return cost;
+             }},
+            {"bidirectional", "bidirectional",
+             [&](const Trip& trip)
+             {
+                 return compact.findShortestPathBidirectional(
+                     trip.startVertex, trip.endVertex, DistanceWeight{}, forward, backward).cost;
+             }},
+            {"astar", geometry != nullptr ? "a*" : "a* (no geometry)",
+             [&](const Trip& trip)
+             {
+                 if (geometry == nullptr)
+                 {
+                     return compact.findShortestPathAStar(
+                         trip.startVertex, trip.endVertex, DistanceWeight{},
+                         [](int)
+                         {
+                             return 0.0;
+                         },
+                         forward).cost;
+                 }
+                 RoadMapHeuristic heuristic{*geometry, trip.endVertex, TripMetric::Distance, fastest};
+                 return compact.findShortestPathAStar(
+                     trip.startVertex, trip.endVertex, DistanceWeight{}, heuristic, forward).cost;
+             }},
+            {"hierarchy", "contraction hierarchy",
+             [&](const Trip& trip)
+             {
+                 return hierarchy->findShortestPath(trip.startVertex, trip.endVertex, forward, backward).cost;
+             }}};
+
+        std::cout << "  " << std::left << std::setw(24) << "engine" << std::right
+                  << std::setw(12) << "p50 us" << std::setw(12) << "p90 us"
+                  << std::setw(12) << "p99 us" << std::setw(12) << "max us"
+                  << std::setw(12) << "mismatches" << '\n';
+
+        std::vector<double> expected;
+        int mismatches = 0;
+        for (const Engine& engine : engines)
+        {
+            if (engine.key != "dijkstra" && !isSelected(engine.key))
+            {
+                continue;
+            }
+
+            std::vector<double> latencies;
+            int wrong = 0;
+            for (std::size_t i = 0; i < trips.size(); ++i)
+            {
+                start = Clock::now();
+                double cost = engine.cost(trips[i]);
+                latencies.push_back(millisecondsSince(start) * 1000.0);
+
+                if (expected.size() < trips.size())
+                {
+                    expected.push_back(cost);
+                }
+                else if (!sameCost(cost, expected[i]))
+                {
+                    ++wrong;
+                }
+            }
+
+            std::sort(latencies.begin(), latencies.end());
+            auto percentile =
+                [&latencies](double p)
+                {
+                    return latencies[static_cast<std::size_t>(p * (latencies.size() - 1))];
+                };
+
+            std::cout << "  " << std::left << std::setw(24) << engine.name << std::right
+                      << std::setw(12) << percentile(0.50) << std::setw(12) << percentile(0.90)
+                      << std::setw(12) << percentile(0.99) << std::setw(12) << latencies.back()
+                      << std::setw(12) << wrong << '\n';
+            mismatches += wrong;
+        }
+        return mismatches;
+    }
+
+
+    //runs the whole benchmark on one workload, returning the number of
+    //costs that didn't match
+    int runWorkload(const Workload& workload, const Options& options)
+    {
+        std::cout << workload.name << '\n';
+
+        double before = residentMegabytes();
+        Clock::time_point start = Clock::now();
+        RoadMapReader reader;
+        RoadMap roadMap;
+        if (workload.file.empty())
+        {
+            std::istringstream text{workload.text};
+            InputScanner in{text};
+            roadMap = reader.readRoadMap(in);
+        }
+        else
+        {
+            InputScanner in{workload.file};
+            roadMap = reader.readRoadMap(in);
+        }
+        double readTime = millisecondsSince(start);
+        double readMemory = residentMegabytes() - before;
+
+        before = residentMegabytes();
+        start = Clock::now();
+        CompactRoadMap compact{roadMap};
+        double compactTime = millisecondsSince(start);
+        double compactMemory = residentMegabytes() - before;
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "  " << compact.vertexCount() << " locations, " << compact.edgeCount() << " road segments" << '\n';
+        std::cout << "  load: " << readTime << " ms reading (" << readMemory << " MB), "
+                  << compactTime << " ms compacting (" << compactMemory << " MB)" << '\n';
+
+        start = Clock::now();
+        std::vector<int> components = roadMap.stronglyConnectedComponents();
+        double roadMapTime = millisecondsSince(start);
+        start = Clock::now();
+        std::vector<int> compactComponents = compact.stronglyConnectedComponents();
+        double compactComponentTime = millisecondsSince(start);
+        int componentCount = components.empty() ? 0 : 1 + *std::max_element(components.begin(), components.end());
+        std::cout << "  strongly connected components: " << componentCount << " (" << roadMapTime
+                  << " ms on the roadmap, " << compactComponentTime << " ms compacted)" << '\n';
+
+        std::mt19937 random{options.seed};
+        std::uniform_int_distribution<int> vertex{0, compact.vertexCount() - 1};
+        auto randomTrips =
+            [&](int count, bool mixed)
+            {
+                std::vector<Trip> trips;
+                for (int i = 0; i < count; ++i)
+                {
+                    TripMetric metric = mixed && i % 2 == 1 ? TripMetric::Time : TripMetric::Distance;
+                    trips.push_back(Trip{compact.vertexAt(vertex(random)), compact.vertexAt(vertex(random)), metric});
+                }
+                return trips;
+            };
+
+        int mismatches = runEngines(
+            roadMap, compact, workload.geometry.get(), randomTrips(options.queries, false), options.engines);
+
+        TripSolver solver{compact, options.workers};
+        std::vector<Trip> batch = randomTrips(options.trips, true);
+        start = Clock::now();
+        std::vector<DigraphPath> paths = solver.solveTrips(batch);
+        double batchTime = millisecondsSince(start);
+        std::cout << "  batch: " << batch.size() << " trips in " << batchTime << " ms ("
+                  << batch.size() / (batchTime / 1000.0) << " trips/s)" << '\n';
+        std::cout << std::defaultfloat << std::setprecision(6);
+
+        if (mismatches != 0)
+        {
+            std::cout << "  MISMATCHED COSTS: " << mismatches << '\n';
+        }
+        std::cout << std::endl;
+        return mismatches;
+    }
+
+
+    //splits a comma-separated list into its items
+    std::vector<std::string> splitList(const std::string& text)
+    {
+        std::vector<std::string> items;
+        std::istringstream in{text};
+        std::string item;
+        while (std::getline(in, item, ','))
+        {
+            items.push_back(item);
+        }
+        return items;
+    }
+}
+
+
+//With --map, the benchmark runs on the road map in the given file (in the
+//same text format the program reads; any trips after it are ignored),
+//steering A* by the geometry in the file given with --geometry, if any.
+//Otherwise it makes up a grid map and a scale-free map of each of the
+//sizes given with --sizes (about that many locations each).  --engines
+//chooses which engines run besides Dijkstra's algorithm on the compact map,
+//which always does, since it's what the others are checked against.
+//--queries is how many trips each engine answers one at a time, --trips
+//how many are in the batch, which --workers threads (by default, one per
+//hardware thread) share.  --seed changes which maps and trips are made up.
+int main(int argc, char* argv[])
+{
+    Options options;
+    bool usage = false;
+
+    try
+    {
+        for (int i = 1; i < argc && !usage; i += 2)
+        {
+            std::string name = argv[i];
+            std::string value = i + 1 < argc ? argv[i + 1] : "";
+            if (i + 1 >= argc)
+            {
+                usage = true;
+            }
+            else if (name == "--map")
+            {
+                options.mapFile = value;
+            }
+            else if (name == "--geometry")
+            {
+                options.geometryFile = value;
+            }
+            else if (name == "--sizes")
+            {
+                options.sizes.clear();
+                for (const std::string& size : splitList(value))
+                {
+                    options.sizes.push_back(std::stoi(size));
+                }
+            }
+            else if (name == "--engines")
+            {
+                options.engines = splitList(value);
+            }
+            else if (name == "--queries")
+            {
+                options.queries = std::stoi(value);
+            }
+            else if (name == "--trips")
+            {
+                options.trips = std::stoi(value);
+            }
+            else if (name == "--workers")
+            {
+                options.workers = static_cast<unsigned>(std::stoul(value));
+            }
+            else if (name == "--seed")
+            {
+                options.seed = static_cast<unsigned>(std::stoul(value));
+            }
+            else
+            {
+                usage = true;
+            }
+        }
+    }
+    catch (const std::exception&)
+    {
+        usage = true;
+    }
+
+    if (usage || options.queries < 1 || options.trips < 1)
+    {
+        std::cerr << "usage: " << argv[0] << " [--map FILE [--geometry FILE] | --sizes N,N,...]"
+                  << " [--engines roadmap,bidirectional,astar,hierarchy]"
+                  << " [--queries N] [--trips N] [--workers N] [--seed N]" << std::endl;
+        return 1;
+    }
+
+    // Each made-up map is made just before it's run, so that only one of
+    // them is in memory at a time.
+    int mismatches = 0;
+    if (!options.mapFile.empty())
+    {
+        Workload workload{options.mapFile, "", options.mapFile, nullptr};
+        if (!options.geometryFile.empty())
+        {
+            std::ifstream geometryFile{options.geometryFile};
+            InputReader in{geometryFile};
+            RoadMapGeometryReader geometryReader;
+            workload.geometry = std::make_shared<RoadMapGeometry>(geometryReader.readGeometry(in));
+        }
+        mismatches += runWorkload(workload, options);
+    }
+
+    for (int size : options.mapFile.empty() ? options.sizes : std::vector<int>{})
+    {
+        int side = std::max(2, static_cast<int>(std::lround(std::sqrt(static_cast<double>(size)))));
+        SyntheticRoadMap grid = makeGridRoadMap(side, side, options.seed);
+        mismatches += runWorkload(
+            Workload{
+                "grid " + std::to_string(side) + "x" + std::to_string(side), std::move(grid.text), "",
+                std::make_shared<RoadMapGeometry>(std::move(grid.geometry))},
+            options);
+
+        int locations = std::max(2, size);
+        SyntheticRoadMap scaleFree = makeScaleFreeRoadMap(locations, 2, options.seed);
+        mismatches += runWorkload(
+            Workload{
+                "scale-free " + std::to_string(locations), std::move(scaleFree.text), "",
+                std::make_shared<RoadMapGeometry>(std::move(scaleFree.geometry))},
+            options);
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
+
@@ -6,173 +6,196 @@
 // This is the program's main() function, which is the entry point for your
 // console user interface.
 
-#include "InputReader.hpp"
+#include "InputScanner.hpp"
 #include "RoadMapReader.hpp"
 #include "TripReader.hpp"
 #include "Digraph.hpp"
 #include "RoadMapWriter.hpp"
+#include "ReportWriter.hpp"
+#include "TripSolver.hpp"
+#include "VertexOrder.hpp"
 #include <vector>
-#include <map>
 #include <iostream>
+#include <fstream>
 #include <string>
-#include <iomanip>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
 
-//Output when asking for the shortest distance.
-void minDistance(Trip& trip, RoadMap& roadMap)
+namespace
 {
-    std::cout << "Shortest distance from " + roadMap.vertexInfo(trip.startVertex) + "to " + roadMap.vertexInfo(trip.endVertex) << std::endl;
-    std::cout << "  Begin at " + roadMap.vertexInfo(trip.startVertex) << std::endl;
-    double sumDistance = 0.0;
-    std::map<int, int> shortestPath = roadMap.findShortestPaths(trip.startVertex, [](RoadSegment edgeInfo){return edgeInfo.miles;});
-    std::string s = "";
-    int vertex = trip.endVertex;
-    while(true)
+    //lays the road map out again in the order named by --order (see
+    //VertexOrder.hpp), or leaves it in the order it was read in
+    CompactRoadMap reorder(const CompactRoadMap& roadMap, const std::string& order)
     {
-        if(vertex == trip.startVertex)
+        if(order == "bfs")
         {
-            break;
+            return roadMap.renumbered(cuthillMcKeeOrder(roadMap));
         }
-
-        float distance = (int)(roadMap.edgeInfo(shortestPath[vertex], vertex).miles * 10 + 0.5);
-        distance = distance / 10;
-        if(roadMap.edgeInfo(shortestPath[vertex], vertex).miles == 1)
+        else if(order == "dissection")
         {
-            s = "  Continue to " + roadMap.vertexInfo(shortestPath[vertex]) + " (1.0 mile)\n" + s;
+            return roadMap.renumbered(nestedDissectionOrder(roadMap));
         }
-        else
+        return roadMap;
+    }
+
+
+    //writes the summary asked for by --stats: the time spent reading the
+    //input, the work and time of all the searches together, and then the
+    //trips whose searches took longest, which are the ones worth a look
+    void writeStats(
+        std::ostream& out, double parseSeconds, const std::vector<Trip>& trips,
+        const SearchStats& total, const std::vector<SearchStats>& stats)
+    {
+        out << "trips: " << trips.size() << '\n';
+        out << "parse seconds: " << parseSeconds << '\n';
+        out << "search seconds: " << total.searchSeconds << '\n';
+        out << "path seconds: " << total.pathSeconds << '\n';
+        out << "settled: " << total.settled << '\n';
+        out << "relaxed: " << total.relaxed << '\n';
+        out << "pushes: " << total.pushes << '\n';
+        out << "pops: " << total.pops << " (" << total.stalePops << " stale)\n";
+
+        const std::size_t slowestCount = 10;
+        std::vector<std::size_t> slowest(stats.size());
+        for(std::size_t i = 0; i < slowest.size(); i++)
         {
-            s = "  Continue to " + roadMap.vertexInfo(shortestPath[vertex]) + 
-                " (" + std::to_string(int(distance)) + "." + std::to_string(int((distance - (int)distance)*10 + 0.5)) + " miles)\n" + s;
+            slowest[i] = i;
         }
-        
-        sumDistance += roadMap.edgeInfo(shortestPath[vertex], vertex).miles;
-        vertex = shortestPath[vertex];
+        std::stable_sort(
+            slowest.begin(), slowest.end(),
+            [&stats](std::size_t a, std::size_t b)
+            {
+                return stats[a].searchSeconds > stats[b].searchSeconds;
+            });
+        slowest.resize(std::min(slowest.size(), slowestCount));
+
+        out << "slowest trips:" << '\n';
+        for(std::size_t i : slowest)
+        {
+            const Trip& trip = trips[i];
+            out << "  #" << i + 1 << " " << trip.startVertex << " -> " << trip.endVertex
+                << (trip.metric == TripMetric::Distance ? " D" : " T")
+                << ": search seconds " << stats[i].searchSeconds
+                << ", path seconds " << stats[i].pathSeconds
+                << ", settled " << stats[i].settled
+                << ", relaxed " << stats[i].relaxed
+                << ", pushes " << stats[i].pushes
+                << ", pops " << stats[i].pops << " (" << stats[i].stalePops << " stale)" << '\n';
+        }
+        out.flush();
     }
-    std::cout << s;
-    std::cout << "Total distance: " << std::setprecision(2) << sumDistance << " miles" << std::endl;
 }
 
-//Change time to a string, (hrs, mins, secs) format
-std::string timeString(double time)
+
+//Where the road map comes from: the standard input, ahead of the trips (by
+//default), or a binary road map file given with --map.  With --write-map,
+//the road map on the standard input is converted to a binary road map file
+//instead, and no trips are read.  --format chooses how the trips are
+//reported (see ReportWriter.hpp).  --order lays the road map out in memory
+//(or in the binary road map file being written) breadth-first or by nested
+//dissection, rather than in the order it was read in, which makes searches
+//faster without changing what they find (except, possibly, which of
+//several shortest paths is chosen).  --stats writes a summary of the work
+//the searches did, and the trips that took longest, to the given file.
+int main(int argc, char* argv[])
 {
-    int hr = int(time);
-    int min = int((time - hr) * 60);
-    double sec = time*3600 - hr*3600 - min*60;
+    std::string option;
+    std::string file;
+    ReportFormat format = ReportFormat::Text;
+    std::string order = "input";
+    std::string statsFile;
+    bool usage = false;
 
-    std::string t = "";
-    if(hr != 0)
+    for(int i = 1; i < argc && !usage; i += 2)
     {
-        if(hr == 1)
-        {
-            t += "1 hr ";
-        }
-        else
+        std::string name = argv[i];
+        std::string value = i + 1 < argc ? argv[i + 1] : "";
+        if((name == "--map" || name == "--write-map") && option.empty() && i + 1 < argc)
         {
-            t += std::to_string(hr) + " hrs ";
+            option = name;
+            file = value;
         }
-        if(min == 1)
+        else if(name == "--format" && (value == "text" || value == "csv" || value == "json"))
         {
-            t += "1 min ";
+            format = value == "text" ? ReportFormat::Text : (value == "csv" ? ReportFormat::Csv : ReportFormat::Json);
         }
-        else
+        else if(name == "--order" && (value == "input" || value == "bfs" || value == "dissection"))
         {
-            t += std::to_string(min) + " mins ";
+            order = value;
         }
-        if(sec == 1)
+        else if(name == "--stats" && i + 1 < argc)
         {
-            t += "1.0 sec";
+            statsFile = value;
         }
         else
         {
-            float second = (int)(sec * 10 + 0.5);
-            second = second / 10;
-            t = t + std::to_string(int(second)) + "." + std::to_string(int((second - (int)second)*10 + 0.5)) + "secs";
-        }   
+            usage = true;
+        }
     }
-    else
+
+    if(usage)
     {
-        if(min == 1)
-        {
-            t += "1 min ";
-        }
-        else if(min > 1)
+        std::cerr << "usage: " << argv[0] << " [--map FILE | --write-map FILE] [--format text|csv|json] [--order input|bfs|dissection] [--stats FILE]" << std::endl;
+        return 1;
+    }
+
+    InputScanner reader{std::cin};
+    RoadMapReader roadR;
+    TripReader tripR;
+
+    if(option == "--write-map")
+    {
+        std::ofstream out{file, std::ios::binary};
+        RoadMapWriter roadW;
+        roadW.writeBinaryRoadMap(out, reorder(CompactRoadMap{roadR.readRoadMap(reader)}, order));
+        if(!out)
         {
-            t += std::to_string(min) + " mins ";
+            std::cerr << "cannot write " << file << std::endl;
+            return 1;
         }
-        if(sec == 1)
+        return 0;
+    }
+
+    std::chrono::steady_clock::time_point parseStart = std::chrono::steady_clock::now();
+    CompactRoadMap roadMap;
+    if(option == "--map")
+    {
+        try
         {
-            t += "1.0 sec";
+            roadMap = roadR.mapBinaryRoadMap(file);
         }
-        else
+        catch(const std::runtime_error& e)
         {
-            float second = (int)(sec * 10 + 0.5);
-            second = second / 10;
-            t = t + std::to_string(int(second)) + "." + std::to_string(int((second - (int)second)*10 + 0.5)) + " secs";
+            std::cerr << e.what() << std::endl;
+            return 1;
         }
     }
-    return t;
-}
-
-//Output when asking for the shortest time.
-void minTime(Trip& trip, RoadMap& roadMap)
-{
-    std::cout << "Shortest driving time from " + roadMap.vertexInfo(trip.startVertex) + "to " + roadMap.vertexInfo(trip.endVertex) << std::endl;
-    std::cout << "  Begin at " + roadMap.vertexInfo(trip.startVertex) << std::endl;
-    double sumTime = 0.0;
-    std::map<int, int> shortestPath = roadMap.findShortestPaths(trip.startVertex, [](RoadSegment edgeInfo){return edgeInfo.miles / edgeInfo.milesPerHour;});
-    std::string s = "";
-    int vertex = trip.endVertex;
-    while(true)
+    else
     {
-        if(vertex == trip.startVertex)
-        {
-            break;
-        }
-        float distance = (int)(roadMap.edgeInfo(shortestPath[vertex], vertex).miles * 10 + 0.5);
-        distance = distance / 10;
-
-        float speed = (int)(roadMap.edgeInfo(shortestPath[vertex], vertex).milesPerHour * 10 + 0.5);
-        speed = speed / 10;
-
-        double time = roadMap.edgeInfo(shortestPath[vertex], vertex).miles / roadMap.edgeInfo(shortestPath[vertex], vertex).milesPerHour;
-        std::string t = timeString(time);
-
-        s = "  Continue to " + roadMap.vertexInfo(shortestPath[vertex]) + 
-            " (" + std::to_string(int(distance)) + "." + std::to_string(int((distance - (int)distance)*10 + 0.5)) + " miles @ " + 
-            std::to_string(int(speed)) + "." + std::to_string(int((speed - (int)speed)*10 + 0.5)) + "mph = " + t +")\n" + s;
-
-        sumTime += roadMap.edgeInfo(shortestPath[vertex], vertex).miles / roadMap.edgeInfo(shortestPath[vertex], vertex).milesPerHour;
-        vertex = shortestPath[vertex];
+        roadMap = CompactRoadMap{roadR.readRoadMap(reader)};
     }
-    std::cout << s;
-    std::string tSum = timeString(sumTime);
-    std::cout << "Total time: " << tSum << std::endl;
-}
-
-
-
-int main()
-{
-    InputReader reader(std::cin);
-    RoadMapReader roadR;
-    TripReader tripR;
-    RoadMap roadMap = roadR.readRoadMap(reader);
+    roadMap = reorder(roadMap, order);
     std::vector<Trip> tripV = tripR.readTrips(reader);
-    //RoadMapWriter roadW;
-    //roadW.writeRoadMap(std::cout, roadMap);
-    for (auto trip: tripV)
+    double parseSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - parseStart).count();
+    TripSolver solver{roadMap};
+    solver.setKeepingStats(!statsFile.empty());
+    std::vector<DigraphPath> paths = solver.solveTrips(tripV);
+    if(!statsFile.empty())
     {
-        if(trip.metric == TripMetric::Distance)
+        std::ofstream statsOut{statsFile};
+        writeStats(statsOut, parseSeconds, tripV, solver.batchStats(), solver.tripStats());
+        if(!statsOut)
         {
-            minDistance(trip, roadMap);
-            std::cout << std::endl;
+            std::cerr << "cannot write " << statsFile << std::endl;
+            return 1;
         }
-        else
-        {
-            minTime(trip, roadMap);
-            std::cout << std::endl;
-        } 
     }
+    ReportWriter report{std::cout, roadMap, format};
+    for (std::size_t i = 0; i < tripV.size(); i++)
+    {
+        report.writeTrip(tripV[i], paths[i]);
+    }
+    report.flush();
     return 0;
 }
-
@@ -0,0 +1,151 @@
+// DigraphCopyTests.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This is the main() function of a test of Digraph copies, which share
+// their parts until one of them changes a part (see CopyOnWrite.hpp).
+// Each test changes a Digraph and a copy of it on two threads at once and
+// checks that neither sees the other's changes.  The tests are meant to be
+// run in a build with ThreadSanitizer (-fsanitize=thread), which reports
+// any unsynchronized hand-off of the parts between the two threads; the
+// program exits with status 1 if a check fails.
+
+#include <iostream>
+#include <thread>
+#include "Digraph.hpp"
+
+namespace
+{
+    int failures = 0;
+
+
+    //reports a failed check
+    void check(bool passed, const char* what)
+    {
+        if(!passed)
+        {
+            std::cerr << "FAILED: " << what << std::endl;
+            failures++;
+        }
+    }
+
+
+    //returns a path of the given number of vertices, where the edge
+    //leaving vertex i has EdgeInfo i
+    Digraph<int, int> makePath(int vertexCount)
+    {
+        Digraph<int, int> d;
+        for(int i = 0; i < vertexCount; i++)
+        {
+            d.addVertex(i, i);
+        }
+        for(int i = 0; i + 1 < vertexCount; i++)
+        {
+            d.addEdge(i, i + 1, i);
+        }
+        return d;
+    }
+
+
+    // A Digraph and its copy each change every edge, so every part they
+    // share is written by both of them at about the same time.
+    void changeEdgesOfCopies()
+    {
+        const int vertexCount = 200;
+        for(int round = 0; round < 50; round++)
+        {
+            Digraph<int, int> original = makePath(vertexCount);
+            Digraph<int, int> copy{original};
+
+            std::thread first{
+                [&original]
+                {
+                    for(int i = 0; i + 1 < vertexCount; i++)
+                    {
+                        original.setEdgeInfo(i, i + 1, -i);
+                    }
+                }};
+            std::thread second{
+                [&copy]
+                {
+                    for(int i = 0; i + 1 < vertexCount; i++)
+                    {
+                        copy.setEdgeInfo(i, i + 1, 2 * i);
+                    }
+                }};
+            first.join();
+            second.join();
+
+            bool separate = true;
+            for(int i = 0; i + 1 < vertexCount; i++)
+            {
+                separate = separate
+                    && original.edgeInfo(i, i + 1) == -i
+                    && copy.edgeInfo(i, i + 1) == 2 * i;
+            }
+            check(separate, "a Digraph and its copy changed on two threads");
+        }
+    }
+
+
+    // A Digraph and its copy each change a different chunk of vertices
+    // first, so each is left as the only owner of a chunk whose lists take
+    // their memory from the other's arena, and then they both add edges
+    // to those chunks.
+    void addEdgesToCopies()
+    {
+        const int vertexCount = 128;
+        for(int round = 0; round < 50; round++)
+        {
+            Digraph<int, int> original = makePath(vertexCount);
+            Digraph<int, int> copy{original};
+            copy.setEdgeInfo(0, 1, 100);
+            original.setEdgeInfo(64, 65, 100);
+
+            std::thread first{
+                [&original]
+                {
+                    for(int i = 2; i < 64; i++)
+                    {
+                        original.addEdge(0, i, i);
+                    }
+                }};
+            std::thread second{
+                [&copy]
+                {
+                    for(int i = 66; i < vertexCount; i++)
+                    {
+                        copy.addEdge(64, i, i);
+                    }
+                }};
+            first.join();
+            second.join();
+
+            check(original.edgeCount() == vertexCount - 1 + 62
+                  && copy.edgeCount() == vertexCount - 1 + 62,
+                  "edges added to a Digraph and its copy on two threads");
+            check(original.edgeInfo(0, 63) == 63 && copy.edgeInfo(64, 127) == 127,
+                  "edges added to a Digraph and its copy are kept apart");
+            check(original.edgeInfo(0, 1) == 0 && copy.edgeInfo(0, 1) == 100
+                  && original.edgeInfo(64, 65) == 100 && copy.edgeInfo(64, 65) == 64,
+                  "edges changed before the threads started are kept apart");
+            check(original.edgeCount(64) == 1 && copy.edgeCount(0) == 1,
+                  "neither Digraph sees the other's new edges");
+        }
+    }
+}
+
+
+int main()
+{
+    changeEdgesOfCopies();
+    addEdgesToCopies();
+
+    if(failures > 0)
+    {
+        return 1;
+    }
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+// InputScannerTests.cpp
+//
+// ICS 46 Winter 2021
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This is the main() function of a test of the readers that take their
+// input from an InputScanner, which reserve room for as many locations,
+// road segments, and trips as the input says are coming.  Each test gives
+// them a count that's negative or far larger than the input could hold,
+// and checks that they read what an InputReader would have read, or fail
+// with an InputScannerException, rather than trying to reserve room for
+// the count as it stands.  The program exits with status 1 if a check
+// fails.
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "InputScanner.hpp"
+#include "RoadMapReader.hpp"
+#include "TripReader.hpp"
+
+namespace
+{
+    int failures = 0;
+
+
+    //reports a failed check
+    void check(bool passed, const char* what)
+    {
+        if(!passed)
+        {
+            std::cerr << "FAILED: " << what << std::endl;
+            failures++;
+        }
+    }
+
+
+    // A count of 0 or less means there's nothing to read, as it does to
+    // the readers that take an InputReader.
+    void readNegativeCounts()
+    {
+        std::istringstream in{"-3\n-1\n-2\n"};
+        InputScanner scanner{in};
+
+        RoadMap roadMap = RoadMapReader{}.readRoadMap(scanner);
+        check(roadMap.vertexCount() == 0 && roadMap.edgeCount() == 0,
+              "a road map with negative counts is empty");
+
+        std::vector<Trip> trips = TripReader{}.readTrips(scanner);
+        check(trips.empty(), "a negative number of trips reads none");
+    }
+
+
+    // A count too large for the input runs out of input instead of
+    // reserving room for it.
+    void readHugeCounts()
+    {
+        std::istringstream locations{"2000000000\nAnteater\n"};
+        InputScanner locationScanner{locations};
+        bool threw = false;
+        try
+        {
+            RoadMapReader{}.readRoadMap(locationScanner);
+        }
+        catch(InputScannerException&)
+        {
+            threw = true;
+        }
+        check(threw, "a road map with too many locations runs out of input");
+
+        std::istringstream trips{"2000000000\n0 1 D\n"};
+        InputScanner tripScanner{trips};
+        threw = false;
+        try
+        {
+            TripReader{}.readTrips(tripScanner);
+        }
+        catch(InputScannerException&)
+        {
+            threw = true;
+        }
+        check(threw, "too many trips runs out of input");
+    }
+
+
+    // The cap never falls below the number of lines actually left.
+    void capCounts()
+    {
+        std::istringstream in{"a\nb\nc"};
+        InputScanner scanner{in};
+        check(scanner.capLineCount(-5) == 0, "a negative count is capped at 0");
+        check(scanner.capLineCount(2) == 2, "a count that fits isn't capped");
+        check(scanner.capLineCount(1000) >= 3 && scanner.capLineCount(1000) < 1000,
+              "a count too large for the input is capped");
+    }
+}
+
+
+int main()
+{
+    readNegativeCounts();
+    readHugeCounts();
+    capCounts();
+
+    if(failures > 0)
+    {
+        return 1;
+    }
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}